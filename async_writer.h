@@ -0,0 +1,200 @@
+/* File: async_writer.h
+ * Author: Zach McMichael
+ * Description: buffered file writer that hands full buffers to a background
+ *				thread so the access loop never waits on io
+ *
+ * Full buffers are queued, never waited on. While the file is slower than
+ * the caller the queue grows, and drained buffers are kept for reuse, so
+ * memory only grows while the writer is behind. peak_queued gives how far
+ * behind it got. sync writes in the caller instead, for debug output that
+ * has to stay in order with cout.
+ */
+
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+class AsyncWriter {
+
+  public:
+    size_t capacity; //bytes per buffer before it is handed off
+    bool sync = false; //write in the caller, nothing is queued
+    uint64_t peak_queued = 0; //most bytes waiting on the writer thread at once
+
+    /* open: open the file and start the writer thread
+     * Parameters: string the file name, "-" for stdout
+     *             const char* fopen mode
+     *             size_t bytes per buffer
+     * Returns: bool false if the file could not be opened
+     */
+    bool open(string name, const char* mode, size_t buffer_bytes = 1 << 20) {
+      if(name == "-") {
+        file = stdout;
+      }else{
+        file = fopen(name.c_str(), mode);
+        if(!file) return false;
+      }
+      capacity = buffer_bytes;
+      fill_buf.reserve(capacity);
+      running = true;
+      worker = thread(&AsyncWriter::run, this);
+      return true;
+    }
+
+    bool is_open() {
+      return file != nullptr;
+    }
+
+    /* write: append bytes, handing the buffer off when it fills
+     * Parameters: const void* the bytes
+     *             size_t the length
+     * Returns: None
+     */
+    void write(const void* data, size_t len) {
+      const char* p = (const char*)data;
+      fill_buf.insert(fill_buf.end(), p, p+len);
+      if(sync || fill_buf.size() >= capacity) hand_off();
+    }
+
+    void put(uint8_t byte) {
+      fill_buf.push_back((char)byte);
+      if(sync || fill_buf.size() >= capacity) hand_off();
+    }
+
+    /* reserve_tail: grow the fill buffer and return a pointer to the new
+     *               space so callers can format straight into it
+     * Parameters: size_t the most bytes the caller will write
+     * Returns: char* the start of the space, commit() with what was used
+     */
+    char* reserve_tail(size_t len) {
+      tail = fill_buf.size();
+      fill_buf.resize(tail + len);
+      return &fill_buf[tail];
+    }
+
+    void commit(size_t used) {
+      fill_buf.resize(tail + used);
+      if(sync || fill_buf.size() >= capacity) hand_off();
+    }
+
+    /* flush: hand off whatever is buffered without waiting for the write
+     * Parameters: None
+     * Returns: None
+     */
+    void flush() {
+      if(!fill_buf.empty()) hand_off();
+    }
+
+    /* drain: write out everything buffered and queued and wait for it, for
+     *        the rare message that goes around the writer to the same stream
+     * Parameters: None
+     * Returns: None
+     */
+    void drain() {
+      if(!file) return;
+      flush();
+      unique_lock<mutex> lock(m);
+      drained.wait(lock, [this] { return queue.empty() && !writing; });
+      fflush(file);
+    }
+
+    /* close: write everything out, stop the thread and close the file
+     * Parameters: None
+     * Returns: None
+     */
+    void close() {
+      if(!file) return;
+      flush();
+      {
+        unique_lock<mutex> lock(m);
+        running = false;
+      }
+      ready.notify_one();
+      worker.join();
+      fflush(file);
+      if(file != stdout) fclose(file);
+      file = nullptr;
+    }
+
+    ~AsyncWriter() {
+      close();
+    }
+
+  private:
+    FILE* file = nullptr;
+    vector<char> fill_buf; //filled by the caller
+    deque<vector<char>> queue; //full buffers waiting on the writer thread
+    vector<vector<char>> spare; //written buffers kept for reuse
+    uint64_t queued = 0; //bytes in queue
+    size_t tail = 0;
+    bool writing = false; //the writer thread holds a buffer outside the queue
+    bool running = false;
+    thread worker;
+    mutex m;
+    condition_variable ready; //a buffer was queued or we are stopping
+    condition_variable drained; //the queue is empty and nothing is being written
+
+    /* hand_off: queue the full buffer and carry on with a spare one, never
+     *           waiting on the writer thread
+     * Parameters: None
+     * Returns: None
+     */
+    void hand_off() {
+      if(sync) {
+        fwrite(fill_buf.data(), 1, fill_buf.size(), file);
+        fill_buf.clear();
+        return;
+      }
+      unique_lock<mutex> lock(m);
+      queued += fill_buf.size();
+      if(queued > peak_queued) peak_queued = queued;
+      queue.push_back(move(fill_buf));
+      if(!spare.empty()) {
+        fill_buf = move(spare.back());
+        spare.pop_back();
+      }else{
+        fill_buf = vector<char>();
+        fill_buf.reserve(capacity);
+      }
+      lock.unlock();
+      ready.notify_one();
+    }
+
+    void run() {
+      vector<char> buf;
+      unique_lock<mutex> lock(m);
+
+      while(true) {
+        ready.wait(lock, [this] { return !queue.empty() || !running; });
+        if(!queue.empty()) {
+          buf = move(queue.front());
+          queue.pop_front();
+          queued -= buf.size();
+          writing = true;
+          lock.unlock();
+          fwrite(buf.data(), 1, buf.size(), file);
+          buf.clear();
+          lock.lock();
+          writing = false;
+          //a couple of buffers are enough to absorb the next burst
+          if(spare.size() < 2) spare.push_back(move(buf));
+          if(queue.empty()) drained.notify_all();
+        }else if(!running) {
+          break;
+        }
+      }
+    }
+};
+
+#endif
@@ -0,0 +1,314 @@
+/* File: bench.cpp
+ * Author: Zach McMichael
+ * Description: microbenchmarks for the Global tracker, results are
+ *				appended as csv rows so runs can be compared across commits
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <getopt.h>
+#include "heatmap.h"
+
+using namespace std;
+
+typedef chrono::steady_clock bench_clock;
+
+struct Access {
+  double time;
+  uint64_t addr;
+};
+
+/* elapsed_ns: nanoseconds since a start point
+ * Parameters: bench_clock::time_point the start
+ * Returns: double the elapsed nanoseconds
+ */
+double elapsed_ns(bench_clock::time_point start) {
+  return chrono::duration<double, nano>(bench_clock::now() - start).count();
+}
+
+/* load_trace: read a time,phys_addr csv into memory so parsing is not timed
+ * Parameters: string the trace file
+ * Returns: vector<Access> every access in the file
+ */
+vector<Access> load_trace(string name) {
+  vector<Access> trace;
+  ifstream file(name);
+  string line;
+  size_t comma;
+
+  if(!file.is_open()) {
+    cout << RED << "could not open " << name << RESET << endl;
+    exit(1);
+  }
+  getline(file, line); //remove column names
+  while(getline(file, line)) {
+    comma = line.find(',');
+    if(comma == string::npos) continue;
+    trace.push_back({stod(line.substr(0, comma)), strtoull(line.c_str()+comma+1, nullptr, 16)});
+  }
+  return trace;
+}
+
+/* make_tracker: build a tracker the same way main does
+ * Parameters: char* layer1, layer2, layer3 strings
+ *             float the interval length
+ * Returns: BasicGlobal<Backend> the initialized tracker
+ */
+template<class Backend>
+BasicGlobal<Backend> make_tracker(char* l1, char* l2, char* l3, float interval) {
+  BasicGlobal<Backend> G;
+  G.init();
+  G.parse(l1, l2, l3);
+  G.interval = interval;
+  G.verbose = 0;
+  G.debug = 0;
+  G.setup();
+  return G;
+}
+
+/* run_trace: drive the tracker over the whole trace the same way main does
+ * Parameters: BasicGlobal<Backend>& the tracker
+ *             vector<Access>& the trace
+ * Returns: uint64_t the number of intervals
+ */
+template<class Backend>
+uint64_t run_trace(BasicGlobal<Backend>& G, vector<Access>& trace) {
+  double pause_time = 0;
+  bool first_time = true;
+  uint64_t iteration = 0;
+
+  for(Access& a : trace) {
+    if(first_time) {
+      first_time = false;
+      pause_time = a.time + G.interval;
+    }else if(pause_time < a.time) {
+      pause_time = a.time + G.interval;
+      iteration++;
+      for(int i=0; i<3; i++) {
+        G.cache_hits[i] = 0;
+        G.cache_misses[i] = 0;
+        G.counter_inc[i] = 0;
+        G.counter_dec[i] = 0;
+      }
+      G.heatmap(iteration);
+    }
+    G.record(a.addr);
+  }
+  return iteration;
+}
+
+/* table_bytes: bytes held by the counter tables and region indexes
+ * Parameters: BasicGlobal<Backend>& the tracker
+ * Returns: uint64_t bytes
+ */
+template<class Backend>
+uint64_t table_bytes(BasicGlobal<Backend>& G) {
+  uint64_t bytes = 0;
+
+  for(int p=0; p<3; p++) {
+    bytes += Backend::bytes(G.cache[p]);
+    bytes += G.mmap[p].size()*(sizeof(pair<const uint64_t, uint64_t>) + 4*sizeof(void*));
+  }
+  return bytes;
+}
+
+/* state_hash: fold every counter into one number, so backends can be
+ *             checked against each other after the same trace
+ * Parameters: BasicGlobal<Backend>& the tracker
+ * Returns: uint64_t the hash
+ */
+template<class Backend>
+uint64_t state_hash(BasicGlobal<Backend>& G) {
+  uint64_t h = 0;
+
+  for(int p=0; p<3; p++) {
+    for(uint64_t i=0; i<G.num_cache_regions[p]; i++) h = h*31 + Backend::get(G.cache[p], i);
+    h = h*31 + G.counter_inc[p]*7 + G.counter_dec[p];
+  }
+  return h;
+}
+
+//what one backend run needs from main
+struct BenchRun {
+  char* la;
+  char* lb;
+  char* lc;
+  float interval;
+  int reps;
+  vector<Access>* trace;
+  function<void(string, double, string)> emit;
+};
+
+/* bench_backend: time one counter backend over a loaded trace
+ * Parameters: BenchRun& the configuration and the row writer
+ * Returns: uint64_t state_hash() after one full pass
+ */
+template<class Backend>
+uint64_t bench_backend(BenchRun& b) {
+  vector<Access>& trace = *b.trace;
+  uint64_t n = trace.size();
+  uint64_t intervals = 0;
+  uint64_t sink = 0;
+  uint64_t hash;
+  string prefix = string(Backend::name()) + ".";
+  double best;
+  double ns;
+  int r, p;
+
+  //end to end, best of reps
+  best = 0;
+  for(r=0; r<b.reps; r++) {
+    BasicGlobal<Backend> G = make_tracker<Backend>(b.la, b.lb, b.lc, b.interval);
+    auto start = bench_clock::now();
+    intervals = run_trace(G, trace);
+    ns = elapsed_ns(start);
+    if(r == 0 || ns < best) best = ns;
+  }
+  b.emit(prefix + "end_to_end", best/n, "ns/access");
+  b.emit(prefix + "intervals", intervals, "count");
+
+  //warm a tracker so phases 1 and 2 have a populated mmap
+  BasicGlobal<Backend> G = make_tracker<Backend>(b.la, b.lb, b.lc, b.interval);
+  run_trace(G, trace);
+  hash = state_hash(G);
+  b.emit(prefix + "table_bytes", table_bytes(G), "bytes");
+  if(intervals < 2) G.heatmap(2);
+
+  for(p=0; p<3; p++) {
+    vector<uint64_t> offsets;
+    offsets.reserve(n);
+
+    auto start = bench_clock::now();
+    for(Access& a : trace) {
+      uint64_t index = G.find_offset(p, a.addr);
+      sink += index;
+      if(index != (uint64_t)-1) offsets.push_back(index);
+    }
+    b.emit(prefix + "find_offset_p" + to_string(p), elapsed_ns(start)/n, "ns/call");
+
+    if(offsets.empty()) continue;
+    start = bench_clock::now();
+    for(uint64_t index : offsets) {
+      sink += G.change_counter(p, index);
+    }
+    b.emit(prefix + "change_counter_p" + to_string(p), elapsed_ns(start)/offsets.size(), "ns/call");
+  }
+
+  //heatmap rebuilds from the warmed state, refilling phase 0 between calls
+  best = 0;
+  for(r=0; r<b.reps; r++) {
+    for(Access& a : trace) G.record(a.addr);
+    auto start = bench_clock::now();
+    G.heatmap(2);
+    ns = elapsed_ns(start);
+    if(r == 0 || ns < best) best = ns;
+  }
+  b.emit(prefix + "heatmap_rebuild", best/1000.0, "us/call");
+
+  //keep the optimizer from dropping the lookups
+  if(sink == 42) cout << "";
+  return hash;
+}
+
+int main(int argc, char* argv[]) {
+  int opt;
+  int opt_index = 0;
+  char l1[] = "44,34,4";
+  char l2[] = "34,24,4";
+  char l3[] = "24,14,4";
+  char* la = l1;
+  char* lb = l2;
+  char* lc = l3;
+  float interval = 0.5;
+  int reps = 3;
+  string tag = "local";
+  string level = "O?";
+  string output = "bench_results.csv";
+  string backend = "all";
+
+  static struct option long_options[] = {
+    {      "L1",  required_argument,  0,  'a' },
+    {      "L2",  required_argument,  0,  'b' },
+    {      "L3",  required_argument,  0,  'c' },
+    {"interval",  required_argument,  0,  'i' },
+    {    "reps",  required_argument,  0,  'r' },
+    {     "tag",  required_argument,  0,  't' },
+    {     "opt",  required_argument,  0,  'O' },
+    {  "output",  required_argument,  0,  'o' },
+    { "backend",  required_argument,  0,  'B' },
+    {         0,                  0,  0,   0  }
+  };
+
+  while((opt = getopt_long(argc, argv, ":a:b:c:i:r:t:O:o:B:", long_options, &opt_index)) != -1)
+  {
+    switch(opt)
+    {
+      case 'a': la = optarg; break;
+      case 'b': lb = optarg; break;
+      case 'c': lc = optarg; break;
+      case 'i': interval = atof(optarg); break;
+      case 'r': reps = atoi(optarg); break;
+      case 't': tag = optarg; break;
+      case 'O': level = optarg; break;
+      case 'o': output = optarg; break;
+      case 'B': backend = optarg; break;
+      case ':':
+        printf("option needs a value\n");
+        exit(1);
+      case '?':
+        printf("unknown option: %c\n", optopt);
+        exit(1);
+    }
+  }
+
+  if(optind >= argc) {
+    printf("Usage: bench [--L1 a,b,c --L2 .. --L3 .. --interval s --tag t --opt O2 --output f --backend all|uint64|packed|bitset] trace.csv...\n");
+    exit(1);
+  }
+  if(backend != "all" && backend != "uint64" && backend != "packed" && backend != "bitset") {
+    printf("backend must be all, uint64, packed or bitset\n");
+    exit(1);
+  }
+
+  //write the header only for a fresh results file
+  bool fresh = !ifstream(output).good();
+  ofstream results(output, ios::app);
+  if(fresh) results << "tag,opt,trace,metric,value,unit\n";
+
+  for(; optind < argc; optind++) {
+    string name = argv[optind];
+    vector<Access> trace = load_trace(name);
+    uint64_t n = trace.size();
+
+    if(n == 0) continue;
+    auto emit = [&](string metric, double value, string unit) {
+      results << tag << ',' << level << ',' << name << ',' << metric << ','
+              << value << ',' << unit << '\n';
+      cout << setw(10) << level << "  " << setw(24) << metric << "  "
+           << GREEN << value << RESET << ' ' << unit << "  (" << name << ")\n";
+    };
+
+    BenchRun run = {la, lb, lc, interval, reps, &trace, emit};
+    vector<pair<string, uint64_t>> hashes;
+    if(backend == "all" || backend == "uint64") hashes.push_back({"uint64", bench_backend<Uint64Counters>(run)});
+    if(backend == "all" || backend == "packed") hashes.push_back({"packed", bench_backend<PackedCounters>(run)});
+    if(backend == "all" || backend == "bitset") hashes.push_back({"bitset", bench_backend<BitsetCounters>(run)});
+
+    //every backend has to end up with the same counters
+    for(auto& h : hashes) {
+      if(h.second != hashes[0].second) {
+        cout << RED << h.first << " counters differ from " << hashes[0].first << RESET << endl;
+        exit(1);
+      }
+    }
+  }
+
+  exit(0);
+}
@@ -0,0 +1,190 @@
+#!/bin/bash
+# File: check.sh
+# Author: Zach McMichael
+# Description: runs the optional paths of heatmap on small generated traces
+#              and compares them with the serial default output, run by
+#              make check after heatmap and gen_trace are built
+#
+# Every check prints ok or FAIL with a diff, the exit code is the number
+# of failed checks. Pass check names to run only those.
+
+DIR=${CHECK_DIR:-check_out}
+CONFIG="--L1 34,24,4 --L2 24,18,4 --L3 18,12,4 --interval .02 --format csv --no-color"
+PATTERNS="uniform zipf stride phase"
+RESET="\033[0m"
+RED="\033[31m"
+GREEN="\033[32m"
+failed=0
+
+mkdir -p $DIR
+
+#generate a trace once, 200k accesses over 0.2 seconds is 10 intervals
+trace() {
+  if [ ! -s $DIR/$1.csv ]; then
+    ./gen_trace --pattern $1 --bits 30 --accesses 200000 --phase-len 0.05 --output $DIR/$1.csv > /dev/null || exit 1
+  fi
+  echo $DIR/$1.csv
+}
+
+#the interval rows and totals of a run, summary sections a path adds on top are dropped
+rows() {
+  grep -v -E "^# ($1)"
+}
+
+#compare two files and report
+same() {
+  if cmp -s $2 $3; then
+    printf "${GREEN}ok${RESET}    %s\n" "$1"
+  else
+    printf "${RED}FAIL${RESET}  %s\n" "$1"
+    diff $2 $3 | head -20
+    failed=$((failed+1))
+  fi
+}
+
+#--parallel N parses intervals ahead on worker threads, the counts must not change
+check_parallel() {
+  for p in $PATTERNS; do
+    t=$(trace $p)
+    ./heatmap $CONFIG --dataset $t > $DIR/serial_$p.out
+    for n in 1 3; do
+      ./heatmap $CONFIG --dataset $t --parallel $n | rows "Parallel:" > $DIR/parallel_$p.out
+      same "parallel $n $p" $DIR/serial_$p.out $DIR/parallel_$p.out
+    done
+  done
+}
+
+#a run resumed from a checkpoint prints the same rows after it and the same totals
+check_resume() {
+  for p in $PATTERNS; do
+    t=$(trace $p)
+    ./heatmap $CONFIG --dataset $t > $DIR/serial_$p.out
+    rm -f $DIR/resume.ck
+    ./heatmap $CONFIG --dataset $t --checkpoint $DIR/resume.ck --checkpoint-every 5 > /dev/null
+    ./heatmap $CONFIG --dataset $t --checkpoint $DIR/resume.ck --checkpoint-every 5 --resume > $DIR/resume_$p.out
+    awk -F, '$1 !~ /^[0-9]+$/ || $1 >= 5' $DIR/serial_$p.out > $DIR/serial_tail_$p.out
+    same "resume $p" $DIR/serial_tail_$p.out $DIR/resume_$p.out
+  done
+}
+
+#a rate of 1 samples every line, and the sampler keeps no checkpoint so it refuses --resume
+check_sample() {
+  for p in $PATTERNS; do
+    t=$(trace $p)
+    ./heatmap $CONFIG --dataset $t > $DIR/serial_$p.out
+    ./heatmap $CONFIG --dataset $t --sample-rate 1 | rows "Sampling:|Estimated_accesses:" > $DIR/sample_$p.out
+    same "sample 1 $p" $DIR/serial_$p.out $DIR/sample_$p.out
+  done
+  if ./heatmap $CONFIG --dataset $(trace zipf) --sample-rate .3 --checkpoint $DIR/sample.ck --resume > /dev/null; then
+    printf "${RED}FAIL${RESET}  %s\n" "sample resume accepted"
+    failed=$((failed+1))
+  else
+    printf "${GREEN}ok${RESET}    %s\n" "sample resume refused"
+  fi
+}
+
+#the window totals are the phase 0 accesses of the last intervals, 3 of them for .05 s of .02 s
+#intervals and all of them for a window longer than the trace
+check_window() {
+  for p in $PATTERNS; do
+    t=$(trace $p)
+    for w in .05:3 1000:1000000; do
+      ./heatmap $CONFIG --dataset $t --window ${w%:*} > $DIR/window_$p.out
+      awk -F, -v k=${w#*:} -v want=$DIR/window_want_$p.out -v got=$DIR/window_got_$p.out '
+        $1 !~ /^[0-9]+$/ { next }
+        $2 == 0 { hits[$1] = $3 }
+        $12 != "" {
+          sum = 0
+          for(i = $1; i > $1-k && i >= 0; i--) sum += hits[i]
+          print $1, sum > want
+          print $1, $12 > got
+        }' $DIR/window_$p.out
+      same "window ${w%:*} $p" $DIR/window_want_$p.out $DIR/window_got_$p.out
+    done
+  done
+}
+
+#an export decodes back to each row's count_inc, a counter only grows when count_inc does,
+#and --parallel writes the same bytes
+check_export() {
+  cat > $DIR/export_check.cpp <<'END'
+#include <cstdio>
+#include "export.h"
+int main(int argc, char** argv) {
+  ExportReader r;
+  ExportReader::Interval in;
+  if(argc < 2 || !r.open(argv[1])) return 1;
+  while(r.next_run()) {
+    while(r.next_interval(in)) {
+      for(auto& ph : in.phases) {
+        unsigned long long sum = 0;
+        for(auto& e : ph.entries) sum += e.second;
+        printf("%llu %d %llu\n", (unsigned long long)in.iteration, ph.phase, sum);
+      }
+    }
+  }
+  return 0;
+}
+END
+  g++ -std=c++17 -pthread -I. -o $DIR/export_check $DIR/export_check.cpp || exit 1
+  for p in $PATTERNS; do
+    t=$(trace $p)
+    rm -f $DIR/serial_$p.bin $DIR/parallel_$p.bin
+    ./heatmap $CONFIG --dataset $t --export $DIR/serial_$p.bin > $DIR/export_$p.out
+    ./heatmap $CONFIG --dataset $t --export $DIR/parallel_$p.bin --parallel 3 > /dev/null
+    same "export parallel $p" $DIR/serial_$p.bin $DIR/parallel_$p.bin
+    #the last interval is exported but never gets a row
+    awk -F, '$1 ~ /^[0-9]+$/ { print $1, $2, $7 }' $DIR/export_$p.out > $DIR/export_want_$p.out
+    $DIR/export_check $DIR/serial_$p.bin | head -n $(wc -l < $DIR/export_want_$p.out) > $DIR/export_got_$p.out
+    same "export decode $p" $DIR/export_want_$p.out $DIR/export_got_$p.out
+  done
+}
+
+#heatmap built on the other counter backends counts the same, see counters.h
+check_backends() {
+  for b in PackedCounters BitsetCounters; do
+    make -s -B heatmap COUNTERS=$b > /dev/null && mv heatmap $DIR/heatmap_$b || exit 1
+  done
+  make -s -B heatmap > /dev/null || exit 1
+  for p in $PATTERNS; do
+    t=$(trace $p)
+    ./heatmap $CONFIG --dataset $t > $DIR/serial_$p.out
+    for b in PackedCounters BitsetCounters; do
+      $DIR/heatmap_$b $CONFIG --dataset $t > $DIR/backend_$p.out
+      same "backend $b $p" $DIR/serial_$p.out $DIR/backend_$p.out
+    done
+  done
+}
+
+#tracker.h builds next to names heatmap.h would clash with, and counts a batch like single records
+check_tracker() {
+  cat > $DIR/tracker_check.cpp <<'END'
+#include <cstdio>
+#include "tracker.h"
+struct string {};
+struct vector {};
+int RED = 0, RESET = 0;
+int main() {
+  TrackerConfig c = {{{36, 26, 4}, {26, 18, 4}, {18, 12, 4}}, 0.5};
+  Tracker one, batch;
+  std::string error;
+  uint64_t a[4] = {1, 2, 4096, 1 << 20};
+  if(!one.configure(c, error) || !batch.configure(c, error)) return 1;
+  for(uint64_t x : a) one.record(x, 0.1);
+  batch.record_batch(a, 0.1);
+  one.end_interval();
+  batch.end_interval();
+  printf("%lu %lu\n", (unsigned long)one.totals().phase[0].counter_inc, (unsigned long)batch.totals().phase[0].counter_inc);
+  return 0;
+}
+END
+  echo "4 4" > $DIR/tracker_expected.out
+  g++ -std=c++17 -Wall -Wextra -Werror -I. -o $DIR/tracker_check $DIR/tracker_check.cpp libheatmap.a && $DIR/tracker_check > $DIR/tracker.out
+  same "tracker" $DIR/tracker_expected.out $DIR/tracker.out
+}
+
+CHECKS="parallel resume backends tracker sample window export"
+for c in ${@:-$CHECKS}; do
+  check_$c
+done
+exit $failed
@@ -0,0 +1,205 @@
+/* File: checkpoint.h
+ * Author: Zach McMichael
+ * Description: saves and restores the tracker state at an interval
+ *				boundary so a long run can resume where it stopped
+ *
+ * The file is a fixed CheckpointHeader followed by the phase caches as
+ * uint64_t arrays and the phase mmaps as sorted (region, index) pairs, at
+ * the offsets the header gives. Everything is 8 byte aligned so the file
+ * can be mmapped and read in place.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "heatmap.h"
+
+using namespace std;
+
+//where the main loop was when the checkpoint was taken
+struct Progress {
+  uint64_t iteration; //interval that was about to start
+  uint64_t offset; //byte offset of the first line of that interval
+  double pause_time; //timestamp that ends the interval
+};
+
+struct CheckpointHeader {
+  char magic[8]; //"HMCKPT1"
+  uint64_t header_bytes;
+
+  //configuration the state is only valid for
+  uint64_t num_bits_addressable;
+  uint64_t region_size[3];
+  uint64_t counter_size[3];
+  double interval;
+
+  //loop position
+  uint64_t iteration;
+  uint64_t offset;
+  double pause_time;
+  uint64_t active_phases;
+
+  //running totals
+  uint64_t total_cache_hits[3];
+  uint64_t total_cache_misses[3];
+  uint64_t total_counter_inc[3];
+  uint64_t total_counter_dec[3];
+
+  //where the arrays live
+  uint64_t cache_len[3];
+  uint64_t cache_off[3];
+  uint64_t mmap_len[3];
+  uint64_t mmap_off[3];
+};
+
+/* save_checkpoint: write the tracker state to name.tmp and rename it over
+ *                  name so a crash mid write never leaves a torn file
+ * Parameters: Global& the tracker
+ *             Progress& where the main loop is
+ *             string the checkpoint file
+ * Returns: bool false if the file could not be written
+ */
+inline bool save_checkpoint(Global& G, const Progress& at, string name) {
+  CheckpointHeader h;
+  string tmp = name + ".tmp";
+  uint64_t off = sizeof(CheckpointHeader);
+  vector<uint64_t> pairs;
+  uint64_t i;
+  FILE* f;
+  int p;
+  bool ok;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "HMCKPT1", 8);
+  h.header_bytes = sizeof(CheckpointHeader);
+  h.num_bits_addressable = G.num_bits_addressable;
+  h.interval = G.interval;
+  h.iteration = at.iteration;
+  h.offset = at.offset;
+  h.pause_time = at.pause_time;
+  h.active_phases = G.active_phases;
+  for(p=0; p<3; p++) {
+    h.region_size[p] = G.region_size[p];
+    h.counter_size[p] = G.counter_size[p];
+    h.total_cache_hits[p] = G.total_cache_hits[p];
+    h.total_cache_misses[p] = G.total_cache_misses[p];
+    h.total_counter_inc[p] = G.total_counter_inc[p];
+    h.total_counter_dec[p] = G.total_counter_dec[p];
+    h.cache_len[p] = G.counters(p);
+    h.cache_off[p] = off;
+    off += h.cache_len[p]*sizeof(uint64_t);
+    h.mmap_len[p] = G.mmap[p].size();
+    h.mmap_off[p] = off;
+    off += h.mmap_len[p]*2*sizeof(uint64_t);
+  }
+
+  f = fopen(tmp.c_str(), "wb");
+  if(!f) return false;
+  ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  for(p=0; p<3 && ok; p++) {
+    //counters are written as plain words whatever the backend stores them as
+    pairs.clear();
+    for(i=0; i<h.cache_len[p]; i++) pairs.push_back(G.counter(p, i));
+    ok = fwrite(pairs.data(), sizeof(uint64_t), pairs.size(), f) == pairs.size();
+    pairs.clear();
+    for(auto& m : G.mmap[p]) {
+      pairs.push_back(m.first);
+      pairs.push_back(m.second);
+    }
+    if(ok) ok = fwrite(pairs.data(), sizeof(uint64_t), pairs.size(), f) == pairs.size();
+  }
+  ok = (fclose(f) == 0) && ok;
+  if(!ok) {
+    remove(tmp.c_str());
+    return false;
+  }
+  return rename(tmp.c_str(), name.c_str()) == 0;
+}
+
+/* load_checkpoint: mmap a checkpoint and restore the tracker from it
+ * Parameters: Global& the tracker, already parsed and set up
+ *             Progress& filled with where to continue
+ *             string the checkpoint file
+ *             string& why it failed
+ * Returns: bool false if the file is missing, torn or for another config
+ */
+inline bool load_checkpoint(Global& G, Progress& at, string name, string& error) {
+  struct stat st;
+  const CheckpointHeader* h;
+  const char* base;
+  int fd, p;
+  uint64_t i;
+
+  fd = open(name.c_str(), O_RDONLY);
+  if(fd < 0) {
+    error = "could not open " + name;
+    return false;
+  }
+  if(fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(CheckpointHeader)) {
+    close(fd);
+    error = name + " is too short";
+    return false;
+  }
+  base = (const char*)::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(base == MAP_FAILED) {
+    error = "could not map " + name;
+    return false;
+  }
+  h = (const CheckpointHeader*)base;
+
+  error = "";
+  if(memcmp(h->magic, "HMCKPT1", 8) != 0 || h->header_bytes != sizeof(CheckpointHeader)) {
+    error = name + " is not a checkpoint";
+  }else if(h->num_bits_addressable != (uint64_t)G.num_bits_addressable || h->interval != G.interval) {
+    error = name + " was taken with a different --interval or address width";
+  }
+  for(p=0; p<3 && error.empty(); p++) {
+    if(h->region_size[p] != G.region_size[p] || h->counter_size[p] != (uint64_t)G.counter_size[p]) {
+      error = name + " was taken with different --L1/--L2/--L3";
+    }else if(h->cache_off[p] + h->cache_len[p]*sizeof(uint64_t) > (uint64_t)st.st_size
+        || h->mmap_off[p] + h->mmap_len[p]*2*sizeof(uint64_t) > (uint64_t)st.st_size) {
+      error = name + " is truncated";
+    }
+  }
+  if(!error.empty()) {
+    munmap((void*)base, st.st_size);
+    return false;
+  }
+
+  at.iteration = h->iteration;
+  at.offset = h->offset;
+  at.pause_time = h->pause_time;
+  G.set_phases(h->active_phases);
+  for(p=0; p<3; p++) {
+    const uint64_t* cache = (const uint64_t*)(base + h->cache_off[p]);
+    const uint64_t* pairs = (const uint64_t*)(base + h->mmap_off[p]);
+
+    G.total_cache_hits[p] = h->total_cache_hits[p];
+    G.total_cache_misses[p] = h->total_cache_misses[p];
+    G.total_counter_inc[p] = h->total_counter_inc[p];
+    G.total_counter_dec[p] = h->total_counter_dec[p];
+    G.reset_counters(p, h->cache_len[p]);
+    for(i=0; i<h->cache_len[p]; i++) G.set_counter(p, i, cache[i]);
+
+    //pairs are sorted so every insert lands at the end hint
+    G.mmap[p].clear();
+    for(i=0; i<h->mmap_len[p]; i++) {
+      G.mmap[p].emplace_hint(G.mmap[p].end(), pairs[2*i], pairs[2*i+1]);
+    }
+  }
+  munmap((void*)base, st.st_size);
+  return true;
+}
+
+#endif
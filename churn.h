@@ -0,0 +1,122 @@
+/* File: churn.h
+ * Author: Zach McMichael
+ * Description: how much each rebuild changed the hot set of phases 1 and 2,
+ *				regions entered and left, Jaccard similarity with the last
+ *				set and how many rebuilds a region stays hot for
+ *
+ * The region index is ordered, so the new hot set comes out sorted and one
+ * merge walk against the last sorted set finds every change. Lifetimes are
+ * counted in rebuilds and kept in power of two buckets, 1, 2-3, 4-7, ...
+ */
+
+#ifndef CHURN_H
+#define CHURN_H
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include "hugepage.h"
+
+using namespace std;
+
+class Churn {
+
+  public:
+    static const int BUCKETS = 16; //the last bucket holds everything longer
+
+    struct Phase {
+      vector<pair<uint64_t, uint64_t>> hot; //(region number, rebuilds hot) sorted by region
+      uint64_t sets = 0; //hot sets seen, the first has nothing to compare with
+      uint64_t entered = 0;
+      uint64_t left = 0;
+      uint64_t stayed = 0;
+      double jaccard = 0;
+
+      //over the whole run
+      uint64_t rebuilds = 0;
+      uint64_t total_entered = 0;
+      uint64_t total_left = 0;
+      double sum_jaccard = 0;
+      uint64_t lifetimes[BUCKETS] = {0}; //hot runs by length
+      uint64_t runs = 0;
+      uint64_t run_rebuilds = 0; //sum of the run lengths
+    };
+
+    int enabled = 0; //only keep the hot sets when --churn is passed
+    Phase phases[3]; //phase 0 tracks everything and never churns
+
+    /* update: compare a phase's new hot set with the last one
+     * Parameters: int the phase that was rebuilt
+     *             RegionIndex& its new region index
+     * Returns: None
+     */
+    void update(int p, const RegionIndex& index) {
+      Phase& ph = phases[p];
+      auto last = ph.hot.begin();
+      auto cur = index.begin();
+      uint64_t both;
+
+      next.clear();
+      next.reserve(index.size());
+      ph.entered = ph.left = ph.stayed = 0;
+      while(last != ph.hot.end() || cur != index.end()) {
+        if(cur == index.end() || (last != ph.hot.end() && last->first < cur->first)) {
+          end_run(ph, last->second);
+          ph.left++;
+          last++;
+        }else if(last == ph.hot.end() || cur->first < last->first) {
+          next.push_back(make_pair(cur->first, 1));
+          ph.entered++;
+          cur++;
+        }else{
+          next.push_back(make_pair(cur->first, last->second+1));
+          ph.stayed++;
+          last++;
+          cur++;
+        }
+      }
+      ph.hot.swap(next);
+      if(ph.sets++ == 0) return;
+
+      both = ph.entered + ph.left + ph.stayed;
+      ph.jaccard = both ? (double)ph.stayed/both : 1;
+      ph.rebuilds++;
+      ph.total_entered += ph.entered;
+      ph.total_left += ph.left;
+      ph.sum_jaccard += ph.jaccard;
+    }
+
+    /* finish: close the runs of the regions still hot at the end
+     * Parameters: None
+     * Returns: None
+     */
+    void finish() {
+      for(int p=1; p<3; p++) {
+        for(auto& h : phases[p].hot) end_run(phases[p], h.second);
+        phases[p].hot.clear();
+      }
+    }
+
+    //the last rebuild of phase p had an earlier set to compare with
+    bool valid(int p) const {
+      return phases[p].sets > 1;
+    }
+
+    static uint64_t bucket_low(int b) {
+      return 1ULL << b;
+    }
+
+  private:
+    vector<pair<uint64_t, uint64_t>> next;
+
+    static void end_run(Phase& ph, uint64_t length) {
+      int b = 0;
+
+      while(b < BUCKETS-1 && (length >> (b+1))) b++;
+      ph.lifetimes[b]++;
+      ph.runs++;
+      ph.run_rebuilds += length;
+    }
+};
+
+#endif
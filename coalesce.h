@@ -0,0 +1,108 @@
+/* File: coalesce.h
+ * Author: Zach McMichael
+ * Description: run length pre-aggregation in front of the phase tables,
+ *				repeats to the same finest region within a small window
+ *				become one (region, count) update
+ *
+ * Counters of different regions do not interact and a saturating add of n
+ * splits into inc/full exactly like n single increments, so as long as the
+ * window is flushed before anything reads the tables the interval results
+ * are the same as counting every access on its own.
+ */
+
+#ifndef COALESCE_H
+#define COALESCE_H
+
+#include <cstdint>
+#include <algorithm>
+#include "heatmap.h"
+
+using namespace std;
+
+class Coalescer {
+
+  public:
+    static const int WINDOW = 4; //distinct regions held before the oldest is counted
+
+    int enabled = 0; //only hold accesses back when --coalesce is passed
+    int shift = 0; //log2 of the smallest region in any phase
+    int first = 0; //first phase counted, 1 when phase 0 is counted ahead
+    uint64_t accesses = 0; //accesses taken in
+    uint64_t updates = 0; //(region, count) updates handed to the tables
+
+    /* setup: size the key to the smallest region in the cascade
+     * Parameters: Global& the tracker, after setup()
+     *             int the first phase to count
+     * Returns: None
+     */
+    void setup(const Global& G, int first_phase) {
+      shift = min(G.region_shift_0, min(G.mmap_region_zeros[1], G.mmap_region_zeros[2]));
+      first = first_phase;
+      used = 0;
+      last = 0;
+    }
+
+    /* add: take one access, counting the oldest held region if the window
+     *      is full
+     * Parameters: Global& the tracker
+     *             uint64_t the address
+     * Returns: None
+     */
+    void add(Global& G, uint64_t addr) {
+      uint64_t key = addr >> shift;
+      int i;
+
+      accesses++;
+      //the common case is a run, so look at the last slot hit first
+      if(used && slot[last].key == key) {
+        slot[last].count++;
+        return;
+      }
+      for(i=0; i<used; i++) {
+        if(slot[i].key == key) {
+          slot[i].count++;
+          last = i;
+          return;
+        }
+      }
+      if(used < WINDOW) {
+        i = used++;
+      }else{
+        i = next;
+        next = (next+1) % WINDOW;
+        count(G, slot[i]);
+      }
+      slot[i] = {key, addr, 1};
+      last = i;
+    }
+
+    /* flush: count everything held, before the tables are read
+     * Parameters: Global& the tracker
+     * Returns: None
+     */
+    void flush(Global& G) {
+      for(int i=0; i<used; i++) count(G, slot[i]);
+      used = 0;
+      last = 0;
+      next = 0;
+    }
+
+  private:
+    struct Slot {
+      uint64_t key; //region number at the smallest region size
+      uint64_t addr; //an address in it
+      uint64_t count;
+    };
+
+    Slot slot[WINDOW];
+    int used = 0;
+    int last = 0; //slot hit by the last access
+    int next = 0; //slot evicted next once the window is full
+
+    void count(Global& G, const Slot& s) {
+      G.record_count(s.addr, s.count, first);
+      updates++;
+    }
+};
+
+#endif
@@ -0,0 +1,173 @@
+/* File: counters.h
+ * Author: Zach McMichael
+ * Description: counter storage backends for the phase tables, picked at
+ *				compile time through BasicGlobal<Backend>
+ *
+ * A backend names its Table type and how to size it and read or write one
+ * counter. Everything outside BasicGlobal reads counters through it, so
+ * heatmap and libheatmap.a are built on whichever HEATMAP_COUNTERS names,
+ * Uint64Counters by default, and bench runs all of them on the same trace:
+ *   Uint64Counters   one uint64_t per counter, no shifting or masking
+ *   PackedCounters   counter_size bits per counter packed into 64 bit words
+ *   BitsetCounters   a boost::dynamic_bitset read and written bit by bit,
+ *                    the storage of the old heatmap2 engine
+ * All of them index with the same RegionIndex, the index is not a backend.
+ * The old engine's bitset keyed maps only differed by converting every key
+ * bit by bit.
+ */
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <cstdint>
+#include <vector>
+#include <boost/dynamic_bitset.hpp>
+#include "hugepage.h"
+
+using namespace std;
+
+struct Uint64Counters {
+  typedef CounterTable Table;
+
+  static const char* name() { return "uint64"; }
+
+  static void reset(Table& t, uint64_t n, int) {
+    t.clear();
+    t.resize(n);
+  }
+
+  static uint64_t size(const Table& t) {
+    return t.size();
+  }
+
+  static uint64_t get(const Table& t, uint64_t i) {
+    return t[i];
+  }
+
+  static void set(Table& t, uint64_t i, uint64_t value) {
+    t[i] = value;
+  }
+
+  static uint64_t bytes(const Table& t) {
+    return t.capacity()*sizeof(uint64_t);
+  }
+};
+
+//counters of a fixed width packed back to back, one may straddle two words
+class PackedTable {
+
+  public:
+    int bits = 64;
+    uint64_t mask = ~0ULL;
+    vector<uint64_t, HugePageAllocator<uint64_t>> words;
+
+    void reset(uint64_t n, int width) {
+      bits = width;
+      mask = (bits >= 64) ? ~0ULL : (1ULL << bits)-1;
+      count = n;
+      words.assign((n*bits + 63)/64 + 1, 0); //one spare word so a straddling read never runs off
+    }
+
+    uint64_t get(uint64_t i) const {
+      uint64_t bit = i*bits;
+      uint64_t w = bit >> 6;
+      int off = bit & 63;
+      uint64_t value = words[w] >> off;
+
+      if(off + bits > 64) value |= words[w+1] << (64 - off);
+      return value & mask;
+    }
+
+    void set(uint64_t i, uint64_t value) {
+      uint64_t bit = i*bits;
+      uint64_t w = bit >> 6;
+      int off = bit & 63;
+
+      value &= mask;
+      words[w] = (words[w] & ~(mask << off)) | (value << off);
+      if(off + bits > 64) {
+        words[w+1] = (words[w+1] & ~(mask >> (64 - off))) | (value >> (64 - off));
+      }
+    }
+
+    uint64_t size() const {
+      return count;
+    }
+
+  private:
+    uint64_t count = 0;
+};
+
+struct PackedCounters {
+  typedef PackedTable Table;
+
+  static const char* name() { return "packed"; }
+
+  static void reset(Table& t, uint64_t n, int bits) {
+    t.reset(n, bits);
+  }
+
+  static uint64_t size(const Table& t) {
+    return t.size();
+  }
+
+  static uint64_t get(const Table& t, uint64_t i) {
+    return t.get(i);
+  }
+
+  static void set(Table& t, uint64_t i, uint64_t value) {
+    t.set(i, value);
+  }
+
+  static uint64_t bytes(const Table& t) {
+    return t.words.capacity()*sizeof(uint64_t);
+  }
+};
+
+//counter_size bits per counter in a dynamic_bitset, like heatmap2 kept them
+struct BitsetTable {
+  int bits = 64;
+  boost::dynamic_bitset<uint64_t> store;
+
+  uint64_t size() const {
+    return store.size()/bits;
+  }
+};
+
+struct BitsetCounters {
+  typedef BitsetTable Table;
+
+  static const char* name() { return "bitset"; }
+
+  static void reset(Table& t, uint64_t n, int bits) {
+    t.bits = bits;
+    t.store.clear();
+    t.store.resize(n*bits);
+  }
+
+  static uint64_t size(const Table& t) {
+    return t.size();
+  }
+
+  static uint64_t get(const Table& t, uint64_t i) {
+    uint64_t value = 0;
+    uint64_t base = i*t.bits;
+
+    for(int b=0; b<t.bits; b++) {
+      if(t.store[base+b]) value |= 1ULL << b;
+    }
+    return value;
+  }
+
+  static void set(Table& t, uint64_t i, uint64_t value) {
+    uint64_t base = i*t.bits;
+
+    for(int b=0; b<t.bits; b++) t.store[base+b] = (value >> b) & 1;
+  }
+
+  static uint64_t bytes(const Table& t) {
+    return t.store.num_blocks()*sizeof(uint64_t);
+  }
+};
+
+#endif
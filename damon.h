@@ -0,0 +1,204 @@
+/* File: damon.h
+ * Author: Zach McMichael
+ * Description: region engine in the style of linux DAMON, a bounded list
+ *				of variable size regions that split where accesses inside
+ *				a region diverge and merge where neighbors look alike
+ *
+ * Runs beside the fixed phase cascade on the same accesses. Each region
+ * keeps a saturating access counter plus a count for its lower half, which
+ * is what a split decision is made from. The number of regions is capped
+ * by a memory budget.
+ */
+
+#ifndef DAMON_H
+#define DAMON_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+class DamonEngine {
+
+  public:
+    struct Region {
+      uint64_t start; //first address
+      uint64_t end; //one past the last address
+      uint32_t count; //accesses this interval, saturating
+      uint32_t lower; //accesses to the lower half this interval, saturating
+      uint32_t hot; //region was hot last interval
+    };
+
+    int enabled = 0; //only run when --damon is passed
+    uint64_t budget = 64*1024; //bytes of region state
+    uint64_t min_regions = 10; //never merge below this many
+    uint64_t min_size; //smallest region, the finest phase region size
+    uint64_t max_regions; //regions that fit in the budget
+    int counter_size = 16; //bits in a region counter
+    double split_ratio = 0.5; //halves differing by this share of the region's accesses split it
+    double merge_ratio = 0.25; //neighbors with densities this close merge
+    vector<Region> regions; //sorted by start, covering the whole space
+
+    //results of the last interval, in the same shape as a phase
+    uint64_t cache_hits = 0; //accesses to regions that were hot
+    uint64_t cache_misses = 0; //accesses to the rest
+    uint64_t counter_inc = 0;
+    uint64_t counter_dec = 0; //accesses to a full counter
+    uint64_t splits = 0;
+    uint64_t merges = 0;
+
+    //over the whole run
+    uint64_t total_cache_hits = 0;
+    uint64_t total_cache_misses = 0;
+    uint64_t total_counter_inc = 0;
+    uint64_t total_counter_dec = 0;
+    uint64_t total_splits = 0;
+    uint64_t total_merges = 0;
+    uint64_t peak_regions = 0;
+    uint64_t smallest = ~0ULL; //smallest region ever made
+
+    /* setup: split the address space into min_regions equal regions
+     * Parameters: int bits needed to address the whole space
+     *             uint64_t the finest phase region size
+     * Returns: None
+     */
+    void setup(int addressable_bits, uint64_t finest) {
+      uint64_t space = addressable_bits >= 64 ? ~0ULL : 1ULL << addressable_bits;
+      uint64_t i;
+
+      min_size = finest;
+      max_regions = max(min_regions, budget / sizeof(Region));
+      counter_max = counter_size >= 32 ? ~0U : (1U << counter_size) - 1;
+      regions.clear();
+      for(i=0; i<min_regions; i++) {
+        regions.push_back({space/min_regions*i, i+1 == min_regions ? space : space/min_regions*(i+1), 0, 0, 0});
+      }
+      peak_regions = regions.size();
+    }
+
+    /* access: count one access against the region it falls in
+     * Parameters: uint64_t the address that was accessed
+     * Returns: None
+     */
+    void access(uint64_t addr) {
+      auto it = upper_bound(regions.begin(), regions.end(), addr,
+        [](uint64_t a, const Region& r) { return a < r.start; });
+      if(it == regions.begin()) return;
+      Region& r = *(it-1);
+      if(addr >= r.end) return;
+
+      if(r.hot) cache_hits++;
+      else cache_misses++;
+      if(r.count < counter_max) {
+        r.count++;
+        counter_inc++;
+      }else{
+        counter_dec++;
+      }
+      if(addr < r.start + (r.end - r.start)/2 && r.lower < counter_max) r.lower++;
+    }
+
+    /* end_interval: split, merge, pick the next hot set and clear counts
+     * Parameters: None
+     * Returns: None
+     */
+    void end_interval() {
+      total_cache_hits += cache_hits;
+      total_cache_misses += cache_misses;
+      total_counter_inc += counter_inc;
+      total_counter_dec += counter_dec;
+      splits = split();
+      merges = merge(merge_ratio);
+
+      //over budget, merge ever less alike neighbors until it fits
+      for(double ratio = merge_ratio*2; regions.size() > max_regions; ratio *= 2) merges += merge(ratio);
+      total_splits += splits;
+      total_merges += merges;
+      mark_hot();
+      for(auto& r : regions) {
+        r.count = 0;
+        r.lower = 0;
+        smallest = min(smallest, r.end - r.start);
+      }
+      peak_regions = max(peak_regions, (uint64_t)regions.size());
+    }
+
+    void clear_interval() {
+      cache_hits = 0;
+      cache_misses = 0;
+      counter_inc = 0;
+      counter_dec = 0;
+    }
+
+  private:
+    uint32_t counter_max;
+    vector<Region> scratch;
+
+    static double density(const Region& r) {
+      return (double)r.count / (r.end - r.start);
+    }
+
+    //split a region in half when one half took most of its accesses
+    uint64_t split() {
+      uint64_t made = 0;
+      uint64_t room = max_regions > regions.size() ? max_regions - regions.size() : 0;
+
+      scratch.clear();
+      for(auto& r : regions) {
+        uint64_t size = r.end - r.start;
+        uint64_t upper = r.count - min(r.lower, r.count);
+        uint64_t diff = r.lower > upper ? r.lower - upper : upper - r.lower;
+
+        if(made < room && size >= 2*min_size && r.count >= 2 && diff > split_ratio*r.count) {
+          uint64_t mid = r.start + size/2;
+          scratch.push_back({r.start, mid, r.lower, 0, r.hot});
+          scratch.push_back({mid, r.end, (uint32_t)upper, 0, r.hot});
+          made++;
+        }else{
+          scratch.push_back(r);
+        }
+      }
+      regions.swap(scratch);
+      return made;
+    }
+
+    //merge neighbors whose access densities are within ratio of each other
+    uint64_t merge(double ratio) {
+      uint64_t made = 0;
+
+      scratch.clear();
+      for(auto& r : regions) {
+        if(!scratch.empty() && regions.size() - made > min_regions) {
+          Region& last = scratch.back();
+          double a = density(last), b = density(r);
+          if(fabs(a - b) <= ratio*max(a, b)) {
+            last.end = r.end;
+            last.count = (uint32_t)min((uint64_t)last.count + r.count, (uint64_t)counter_max);
+            made++;
+            continue;
+          }
+        }
+        scratch.push_back(r);
+      }
+      regions.swap(scratch);
+      return made;
+    }
+
+    //regions at least as dense as the accessed regions overall are hot
+    void mark_hot() {
+      uint64_t accesses = 0, bytes = 0;
+      double mean;
+
+      for(auto& r : regions) {
+        if(!r.count) continue;
+        accesses += r.count;
+        bytes += r.end - r.start;
+      }
+      mean = bytes ? (double)accesses / bytes : 0;
+      for(auto& r : regions) r.hot = r.count && density(r) >= mean;
+    }
+};
+
+#endif
@@ -0,0 +1,280 @@
+/* File: export.h
+ * Author: Zach McMichael
+ * Description: streams each interval's non-zero counters to a compact
+ *				append-only binary file
+ *
+ * Layout, every integer is an unsigned LEB128 varint:
+ *   run header:  "HMX1" addressable_bits
+ *                then per phase: log2(region_size) counter_size
+ *   interval:    0x01 interval_number time_ns active_phases
+ *                then per active phase: phase entries
+ *                then per entry: region_delta count
+ *   end of run:  0x00
+ * Regions are region numbers (base address >> log2(region_size)) sorted
+ * ascending, each delta is from the previous region in the same phase
+ * (the first is from 0). A file may hold several runs back to back.
+ * A count is what heatmap() ranks the region by, with --heat separate that
+ * is the read and write cost rather than one counter.
+ */
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include "async_writer.h"
+#include "hugepage.h"
+
+using namespace std;
+
+class Exporter {
+
+  public:
+    int enabled = 0; //only write when --export is passed
+    uint64_t intervals_written = 0;
+    uint64_t entries_written = 0;
+    uint64_t bytes_written = 0;
+    AsyncWriter out;
+
+    /* open: open the export file for appending and write the run header
+     * Parameters: string the file name
+     *             int bits needed to address the whole space
+     *             vector<uint64_t>& the region size per phase
+     *             vector<int>& the counter size per phase
+     * Returns: bool false if the file could not be opened
+     */
+    bool open(string name, int addressable_bits, const vector<uint64_t>& region_size,
+        const vector<int>& counter_size) {
+      if(!out.open(name, "ab")) return false;
+      enabled = 1;
+      out.write("HMX1", 4);
+      bytes_written += 4;
+      varint(addressable_bits);
+      for(size_t p=0; p<region_size.size(); p++) {
+        region_bits.push_back(log2_exact(region_size[p]));
+        varint(region_bits[p]);
+        varint(counter_size[p]);
+      }
+      return true;
+    }
+
+    /* begin_interval: start an interval record
+     * Parameters: uint64_t the interval number
+     *             double the timestamp the interval ended at in seconds
+     *             int how many phases follow
+     * Returns: None
+     */
+    void begin_interval(uint64_t iteration, double time, int phases) {
+      put(0x01);
+      varint(iteration);
+      varint(time > 0 ? (uint64_t)(time*1e9) : 0);
+      varint(phases);
+      intervals_written++;
+    }
+
+    /* write_phase0: write the non-zero counters of the directly indexed phase
+     * Parameters: Global& the tracker
+     * Returns: None
+     */
+    template<class Cascade>
+    void write_phase0(const Cascade& G) {
+      uint64_t i, value, last = 0;
+
+      entries.clear();
+      for(i=0; i<G.counters(0); i++) {
+        value = G.heat(0, i);
+        if(value) entries.push_back(make_pair(i, value));
+      }
+      varint(0);
+      varint(entries.size());
+      for(auto& e : entries) {
+        varint(e.first - last);
+        varint(e.second);
+        last = e.first;
+      }
+      entries_written += entries.size();
+    }
+
+    /* write_phase: write the non-zero counters of an mmap indexed phase, the
+     *              mmap is already sorted by region number
+     * Parameters: int the phase
+     *             Global& the tracker
+     * Returns: None
+     */
+    template<class Cascade>
+    void write_phase(int phase, const Cascade& G) {
+      uint64_t value, last = 0;
+
+      entries.clear();
+      for(auto& m : G.mmap[phase]) {
+        value = (m.second < G.counters(phase)) ? G.heat(phase, m.second) : 0;
+        if(value) entries.push_back(make_pair(m.first, value));
+      }
+      varint(phase);
+      varint(entries.size());
+      for(auto& e : entries) {
+        varint(e.first - last);
+        varint(e.second);
+        last = e.first;
+      }
+      entries_written += entries.size();
+    }
+
+    /* close: mark the end of the run and drain the writer
+     * Parameters: None
+     * Returns: None
+     */
+    void close() {
+      if(!enabled) return;
+      put(0x00);
+      out.close();
+      enabled = 0;
+    }
+
+  private:
+    vector<int> region_bits;
+    vector<pair<uint64_t, uint64_t>> entries; //reused scratch for one phase
+
+    static int log2_exact(uint64_t v) {
+      int bits = 0;
+      while(v > 1) {
+        v >>= 1;
+        bits++;
+      }
+      return bits;
+    }
+
+    void put(uint8_t byte) {
+      out.put(byte);
+      bytes_written++;
+    }
+
+    void varint(uint64_t v) {
+      uint8_t buf[10];
+      int n = 0;
+      while(v >= 0x80) {
+        buf[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+      }
+      buf[n++] = (uint8_t)v;
+      out.write(buf, n);
+      bytes_written += n;
+    }
+};
+
+/* ExportReader: decodes a file written by Exporter
+ * Usage: open(), then next_run() and next_interval() until they return false
+ */
+class ExportReader {
+
+  public:
+    struct Phase {
+      int phase;
+      vector<pair<uint64_t, uint64_t>> entries; //(region number, count)
+    };
+
+    struct Interval {
+      uint64_t iteration;
+      uint64_t time_ns;
+      vector<Phase> phases;
+    };
+
+    int addressable_bits;
+    vector<int> region_bits; //log2 of the region size per phase
+    vector<int> counter_size;
+
+    /* open: read the whole file into memory
+     * Parameters: string the file name
+     * Returns: bool false if it could not be read
+     */
+    bool open(string name) {
+      FILE* f = fopen(name.c_str(), "rb");
+      if(!f) return false;
+      fseek(f, 0, SEEK_END);
+      data.resize(ftell(f));
+      fseek(f, 0, SEEK_SET);
+      if(fread(data.data(), 1, data.size(), f) != data.size()) data.clear();
+      fclose(f);
+      pos = 0;
+      in_run = false;
+      return true;
+    }
+
+    /* next_run: skip to and read the next run header
+     * Parameters: None
+     * Returns: bool false at the end of the file or on a bad header
+     */
+    bool next_run() {
+      Interval skip;
+
+      while(in_run && next_interval(skip));
+      if(pos + 4 > data.size() || data.compare(pos, 4, "HMX1") != 0) return false;
+      pos += 4;
+      addressable_bits = varint();
+      region_bits.clear();
+      counter_size.clear();
+      for(int p=0; p<3; p++) {
+        region_bits.push_back(varint());
+        counter_size.push_back(varint());
+      }
+      in_run = true;
+      return true;
+    }
+
+    /* next_interval: decode the next interval of the current run
+     * Parameters: Interval& where to put it
+     * Returns: bool false at the end of the run
+     */
+    bool next_interval(Interval& out) {
+      uint64_t n, i, region;
+      int p, phases;
+
+      if(!in_run || pos >= data.size()) return in_run = false;
+      if((uint8_t)data[pos] != 0x01) {
+        //0x00 ends the run, anything else is the header of a run that
+        //followed one cut short without its end marker
+        if(data[pos] == 0x00) pos++;
+        return in_run = false;
+      }
+      pos++;
+      out.iteration = varint();
+      out.time_ns = varint();
+      phases = varint();
+      out.phases.resize(phases);
+      for(p=0; p<phases; p++) {
+        out.phases[p].phase = varint();
+        n = varint();
+        out.phases[p].entries.resize(n);
+        region = 0;
+        for(i=0; i<n; i++) {
+          region += varint();
+          out.phases[p].entries[i].first = region;
+          out.phases[p].entries[i].second = varint();
+        }
+      }
+      return true;
+    }
+
+  private:
+    string data;
+    size_t pos = 0;
+    bool in_run = false;
+
+    uint64_t varint() {
+      uint64_t v = 0;
+      int shift = 0;
+      while(pos < data.size()) {
+        uint8_t byte = data[pos++];
+        v |= (uint64_t)(byte & 0x7f) << shift;
+        if(!(byte & 0x80)) break;
+        shift += 7;
+      }
+      return v;
+    }
+};
+
+#endif
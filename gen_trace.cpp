@@ -0,0 +1,184 @@
+/* File: gen_trace.cpp
+ * Author: Zach McMichael
+ * Description: generates synthetic time,phys_addr traces in the same
+ *				csv format as the recorded datasets, or pushes them into a
+ *				heatmap --shm ring as the reference ring producer
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <math.h>
+#include <getopt.h>
+#include "ring.h"
+
+using namespace std;
+
+/* build_zipf_cdf: build the cumulative distribution for a zipf hot set
+ * Parameters: uint64_t the number of hot pages
+ *             double the zipf exponent
+ * Returns: vector<double> the cdf, last entry is 1.0
+ */
+vector<double> build_zipf_cdf(uint64_t n, double alpha) {
+  vector<double> cdf(n);
+  double sum = 0;
+  uint64_t i;
+
+  for(i=0; i<n; i++) {
+    sum += 1.0/pow((double)(i+1), alpha);
+    cdf[i] = sum;
+  }
+  for(i=0; i<n; i++) {
+    cdf[i] /= sum;
+  }
+  return cdf;
+}
+
+/* scramble: spread page numbers across the address space so the hot set
+ *           is not one contiguous block
+ * Parameters: uint64_t the page number
+ * Returns: uint64_t the scrambled page number
+ */
+uint64_t scramble(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return x;
+}
+
+int main(int argc, char* argv[]) {
+  int opt;
+  int opt_index = 0;
+  string pattern = "uniform";
+  string output = "";
+  uint64_t accesses = 1000000;
+  int bits = 34; //address width of the trace
+  int page_bits = 12; //granularity of hot pages
+  uint64_t hot_pages = 4096;
+  double alpha = 0.99;
+  uint64_t stride = 64;
+  double rate = 1000000; //accesses per second
+  double phase_len = 1.0; //seconds before the hot spot moves
+  uint64_t seed = 1;
+  string shm = ""; //ring to push into instead of writing csv
+  bool drop = false; //drop records when the ring is full instead of waiting
+
+  static struct option long_options[] = {
+    {  "pattern",  required_argument,  0,  'p' },
+    { "accesses",  required_argument,  0,  'n' },
+    {     "bits",  required_argument,  0,  'b' },
+    {"page-bits",  required_argument,  0,  'g' },
+    {      "hot",  required_argument,  0,  'h' },
+    {    "alpha",  required_argument,  0,  'a' },
+    {   "stride",  required_argument,  0,  's' },
+    {     "rate",  required_argument,  0,  'r' },
+    {"phase-len",  required_argument,  0,  'l' },
+    {     "seed",  required_argument,  0,  'e' },
+    {   "output",  required_argument,  0,  'o' },
+    {      "shm",  required_argument,  0,  'm' },
+    {     "drop",        no_argument,  0,  'D' },
+    {         0,                  0,  0,   0  }
+  };
+
+  while((opt = getopt_long(argc, argv, ":p:n:b:g:h:a:s:r:l:e:o:m:D", long_options, &opt_index)) != -1)
+  {
+    switch(opt)
+    {
+      case 'p': pattern = optarg; break;
+      case 'n': accesses = strtoull(optarg, nullptr, 10); break;
+      case 'b': bits = atoi(optarg); break;
+      case 'g': page_bits = atoi(optarg); break;
+      case 'h': hot_pages = strtoull(optarg, nullptr, 10); break;
+      case 'a': alpha = atof(optarg); break;
+      case 's': stride = strtoull(optarg, nullptr, 10); break;
+      case 'r': rate = atof(optarg); break;
+      case 'l': phase_len = atof(optarg); break;
+      case 'e': seed = strtoull(optarg, nullptr, 10); break;
+      case 'o': output = optarg; break;
+      case 'm': shm = optarg; break;
+      case 'D': drop = true; break;
+      case ':':
+        printf("option needs a value\n");
+        exit(1);
+      case '?':
+        printf("unknown option: %c\n", optopt);
+        exit(1);
+    }
+  }
+
+  if(bits < page_bits || bits > 63) {
+    printf("bits must be between page-bits and 63\n");
+    exit(1);
+  }
+  if(pattern != "uniform" && pattern != "zipf" && pattern != "stride" && pattern != "phase") {
+    printf("pattern must be one of uniform, zipf, stride, phase\n");
+    exit(1);
+  }
+
+  FILE* out = stdout;
+  ShmRing ring;
+  if(!shm.empty()) {
+    string error;
+    if(!ring.attach(shm, 10, error)) {
+      printf("%s\n", error.c_str());
+      exit(1);
+    }
+  }else if(!output.empty()) {
+    out = fopen(output.c_str(), "w");
+    if(!out) {
+      printf("could not open %s\n", output.c_str());
+      exit(1);
+    }
+  }
+
+  mt19937_64 rng(seed);
+  uint64_t addr_mask = (1ULL << bits) - 1; //bits is at most 63
+  uint64_t page_mask = (1ULL << page_bits) - 1;
+  uint64_t num_pages = 1ULL << (bits - page_bits);
+  uniform_int_distribution<uint64_t> any_addr(0, addr_mask);
+  uniform_real_distribution<double> unit(0.0, 1.0);
+  vector<double> cdf;
+  uint64_t addr = 0;
+  uint64_t page;
+  uint64_t shift = 0;
+  double time;
+  uint64_t i;
+
+  if(pattern == "zipf" || pattern == "phase") {
+    if(hot_pages > num_pages) hot_pages = num_pages;
+    cdf = build_zipf_cdf(hot_pages, alpha);
+  }
+
+  if(shm.empty()) fprintf(out, "time,phys_addr\n");
+  for(i=0; i<accesses; i++) {
+    time = (double)i/rate;
+
+    if(pattern == "uniform") {
+      addr = any_addr(rng);
+    }else if(pattern == "stride") {
+      addr = (addr + stride) & addr_mask;
+    }else {
+      //phase moves the whole hot set to a new part of memory every phase_len seconds
+      if(pattern == "phase") shift = (uint64_t)(time/phase_len);
+      page = lower_bound(cdf.begin(), cdf.end(), unit(rng)) - cdf.begin();
+      if(page >= hot_pages) page = hot_pages-1;
+      page = scramble(page + shift*hot_pages) % num_pages;
+      addr = (page << page_bits) | (rng() & page_mask);
+    }
+
+    if(shm.empty()) fprintf(out, "%.9f,%llx\n", time, (unsigned long long)addr);
+    else ring.push(time, addr, drop);
+  }
+
+  if(!shm.empty()) {
+    ring.finish();
+    printf("records %llu  dropped %llu  stalls %llu\n", (unsigned long long)accesses,
+      (unsigned long long)ring.dropped(), (unsigned long long)ring.stalls());
+  }
+  if(out != stdout) fclose(out);
+  exit(0);
+}
@@ -16,387 +16,90 @@
 #include <math.h>
 #include <boost/dynamic_bitset.hpp>
 #include <getopt.h>
-
-#define RESET   "\033[0m"     
-#define RED     "\033[31m" 
-#define GREEN   "\033[32m" 
-#define MAGENTA "\033[35m" 
-#define CYAN    "\033[36m"
+#include "heatmap.h"
+#include "instrument.h"
+#include "oracle.h"
+#include "export.h"
+#include "report.h"
+#include "checkpoint.h"
+#include "interval_index.h"
+#include "tier.h"
+#include "interval_policy.h"
+#include "damon.h"
+#include "tenants.h"
+#include "ring.h"
+#include "parallel.h"
+#include "hugepage.h"
+#include "tlb.h"
+#include "sampler.h"
+#include "coalesce.h"
+#include "sliding_window.h"
+#include "churn.h"
+#include "predictor.h"
 
 using namespace std;
 
-class Global {
-
-  public:
-    //hard coded vars
-    int debug; //for extra prints for debugging
-    int num_bits_addressable; //the number of bits needed to address the entire mem space
-
-    //passed in parameters
-    float interval; //ammount of time between heatmaping the data
-    int verbose; //extra prints
-    string dataset_name; //name of the dataset
-
-    //for creating the map from the dataset
-    uint64_t first_address_as_uint64_t;
-
-    //for calculating correctness per interval
-    vector<uint64_t> cache_hits; //number of cache hits
-    vector<uint64_t> cache_misses; //number of cache misses
-    vector<uint64_t> counter_inc; //number of time a counter in the cache was incremented
-    vector<uint64_t> counter_dec; //number of time a counter in the cache was not incremented
-    
-    //for calculating correctness overall
-    vector<uint64_t> total_cache_hits; //number of cache hits
-    vector<uint64_t> total_cache_misses; //number of cache misses
-    vector<uint64_t> total_counter_inc; //number of time a counter in the cache was incremented
-    vector<uint64_t> total_counter_dec; //number of time a counter in the cache was not incremented
-
-    //datastructures for cache
-    vector<int> num_region_bits; //number of bits needed to address all addresses in region
-    vector<int> counter_size; //size of the number of bits in for the counter in the cache
-    vector<uint64_t> cache_size; //size of the cache in bits
-    vector<uint64_t> total_data_size; //size of the total amount of data
-    vector<uint64_t> region_size; //size of each region
-    vector<uint64_t> num_cache_regions; //number of regions
-    vector<vector<uint64_t>> cache; //the cache for phase 1, 2, 3
-
-    //datastructures for memory map
-    vector<int> mmap_cache_bits; //number of bits needed in the mmap to offset into the cache
-    vector<int> mmap_region_bits; //number of bits needed in the mmap to figure out which region this beuint64_ts to
-    vector<int> mmap_region_zeros; //number of bits needed in the mmap to pad the address with zeros
-    vector<map<uint64_t, uint64_t>> mmap; //the memory map for phase 2, 3
-    map<uint64_t, uint64_t>::iterator mmap_itter; //iterator for the mmap
-
-    //##### helper functions #####
-
-    /* get_log2_size: 
-     * Parameters: uint64_t the number to figure out the size of
-     * Returns: pair<string, string> the number reduced by the type, the type
-     */
-    pair<string, string> get_log2_size(uint64_t num) {
-      string s_num;
-      string s_type;
-      if(num > pow(2,49)) {
-        cout << "Size is invalid" << endl;
-        exit(1);
-      }else if(num > pow(2, 39)) {
-        s_num = to_string(num/1000000000000);
-        s_type = " Terabytes";
-        return make_pair(s_num, s_type);
-      }else if(num > pow(2, 29)) {
-        s_num = to_string(num/1000000000);
-        s_type = " Gigabytes";
-        return make_pair(s_num, s_type);
-      }else if(num > pow(2, 19)) {
-        s_num = to_string(num/1000000);
-        s_type = " Megabytes";
-        return make_pair(s_num, s_type);
-      }else if(num > pow(2, 9)) {
-        s_num = to_string(num/1000);
-        s_type = " Kilobytes";
-        return make_pair(s_num, s_type);
-      }else {
-        s_num = to_string(num);
-        s_type = " Bytes";
-        return make_pair(s_num, s_type);
-      }
-    }
-
-    /* string_to_uint64_t: Converts an address as a string to a uint64_t
-     * Parameters: string the address to convert
-     * Returns: uint64_t the address as a number
-     */
-    uint64_t string_to_uint64_t(string address) {
-      stringstream ss;
-      uint64_t address_uint64_t;
-
-      ss << hex << address;
-      ss >> address_uint64_t;
-      return address_uint64_t;
-    }
-
-    /* increment: increment the counter by one if it is not maxed
-     * Parameters: int the phase you are on 
-     *             uint64_t the index in the cache to increment
-     * Returns: int 1 if incremented 0 if full
-     */
-    int increment(int phase, uint64_t offset) {
-      uint64_t value = cache[phase][offset];
-
-      if(value < (pow(2, counter_size[phase])-1)){
-        value++;
-        cache[phase][offset] = value;
-        if(debug)cout << "Counter: " << GREEN << cache[phase][offset] << RESET << endl;
-        return 1;
-      }else{
-        return 0;
-      }
-    }
-
-    /* find_offset: find the offset at the specified address for the phase
-     * Parameters: int the phase you are on
-     *             uint64_t the address of the index we need to find
-     * Returns: uint64_t the index
-     */
-    uint64_t find_offset(int phase, uint64_t address_uint64_t) {
-      uint64_t offset = 0;
-
-      if(phase == 0) {
-        //return address_uint64_t >> num_region_bits_phase_1;
-        return ceil(address_uint64_t/region_size[phase]);
-      }else{
-        //convert address to bitset for lookup in mmap
-        if(debug) cout << "Address uint64_t: " << address_uint64_t << "  Address Hex: " 
-          << hex << address_uint64_t << dec << endl;
-        address_uint64_t = address_uint64_t >> mmap_region_zeros[phase];
-
-        //find in mmap and convert from bitset to uint64_t
-        mmap_itter = mmap[phase].find(address_uint64_t);
-        if(mmap_itter == mmap[phase].end()) {
-          if(debug) cout << RED << "Address not found in mmap" << RESET << endl;
-          return -1;
-        }else{
-          offset = mmap_itter->second;
-          if(debug) cout << GREEN << "Address found--  Index" << GREEN << offset << RESET << endl;
-          return offset;
-        }
-      }
-      return -1;
-    }
-
-    //##### main functions #####
-
-    /* init: initilize the maps and vectors
-     * Parameters: None
-     * Returns: None
-     */
-    void init() {
-      //for calculating correctness per interval
-      cache_hits.resize(3);
-      cache_misses.resize(3);
-      counter_inc.resize(3);
-      counter_dec.resize(3);
-      
-      //for calculating total correctness
-      total_cache_hits.resize(3);
-      total_cache_misses.resize(3);
-      total_counter_inc.resize(3);
-      total_counter_dec.resize(3);
-
-      //datastructures for cache
-      num_region_bits.resize(3);
-      counter_size.resize(3);
-      cache_size.resize(3);
-      total_data_size.resize(3);
-      region_size.resize(3);
-      num_cache_regions.resize(3);
-      cache.resize(3);
-
-      //datastructures for memory map
-      mmap_cache_bits.resize(3);
-      mmap_region_bits.resize(3);
-      mmap_region_zeros.resize(3);
-      mmap.resize(3);
-    }
-
-    /* parse: parse the L1, L2, L3 args
-     * Parameters: char* layer1
-     *             char* layer2
-     *             char* layer3
-     * Returns: None
-     */
-    void parse(char* l1, char* l2, char* l3) {
-      int i;
-      string tmp_str;
-      string l1_str(l1);
-      string l2_str(l2);
-      string l3_str(l3);
-      stringstream l1_s_str(l1_str);
-      stringstream l2_s_str(l2_str);
-      stringstream l3_s_str(l3_str);
-      vector<stringstream *> l;
-
-      l.push_back(&l1_s_str);
-      l.push_back(&l2_s_str);
-      l.push_back(&l3_s_str);
-
-      for(i=0; i<3; i++) {
-        getline((*(l[i])), tmp_str, ',');
-        if(i==0) num_bits_addressable = stol(tmp_str);
-        num_region_bits[i] = stol(tmp_str);
-        total_data_size[i] = pow(2,stol(tmp_str));
-        getline((*(l[i])), tmp_str, ',');
-        region_size[i] = pow(2, stol(tmp_str));
-        getline((*(l[i])), tmp_str, ',');
-        counter_size[i] = stol(tmp_str);
-        num_cache_regions[i] = total_data_size[i]/region_size[i];
-        cache_size[i] = num_cache_regions[i]*((float)counter_size[i]/8);
-      }
-    }
-
-    /* change_counter increment the counter in the cache of the desired phase
-     * Parameters: int the phase to be incremented
-     *             uint64_t the index into the cache
-     * Returns: bool if counter was incremented ret 1 if full ret 0
-     */
-    bool change_counter(int phase, uint64_t offset) {
-      uint64_t counter;
-
-      if(increment(phase, offset)) {
-        counter = cache[phase][offset];
-        if(debug) cout << "Phase " << phase << "  Offset: " << hex << offset 
-          << "  Counter: " << dec << counter << endl;
-        return true;
-      }else{
-        counter = cache[phase][offset];
-        if(debug) cout << "Phase " << phase << "  Offset: " << hex << offset 
-          << "  Counter: " << dec << counter << RED <<"  --FULL--" 
-            << RESET << endl;
-        return false;
-      }
-      return false;
-    }
-
-    /* heatmap: runs through and moves counters to next phase
-     * Parameters: uint64_t what iteration we are on
-     * Returns: None
-     */
-    void heatmap(uint64_t iteration) {
-      int p, i, j, k; //for looping
-      bool done = false;
-      typedef pair<uint64_t, uint64_t> pairs; //to add to sets (the number, the index)
-      vector<pairs> max; //maximum number found
-      uint64_t index = 0;
-      uint64_t region = 0;
-      uint64_t num; //number to check size of 
-      uint64_t num_regions_needed; //number of regions needed to fill the next phase
-      uint64_t num_regions_per; //number of subregions per over region
-      uint64_t start_addr; //starting address for region
-
-      for(p=2; p>-1; p--) {
-        //only run phase1 on first interval
-        if(iteration==0) {
-          p=0;
-          //only run phase 1, 2 on second interval
-        }else if(iteration==1 && p==2) {
-          p=1;
-        }
-
-        //clear mmap and cache
-        cache[p].clear();
-        cache[p].resize(num_cache_regions[p]);
-        if(p>0) mmap[p].clear();
-        max.clear();
-        done = false;
-
-        if(p==0) {
-          break;
-        }
-
-        //calculate number of regions to accuire
-        num_regions_needed = total_data_size[p]/region_size[p-1];
-
-        //set iterator to begining
-        if(p>1) mmap_itter = (mmap[p-1]).begin();
-
-        //find hot regions in the above phase
-        for(i=0; i<num_cache_regions[p-1]; i++) {
-          if(p==1) {
-            region = (region_size[p-1])*i;
-            index = i;
-          }else if(p>1) {
-            mmap_itter++;
-            region = mmap_itter->first; 
-            region = region << mmap_region_zeros[p-1];
-            index = mmap_itter->second; 
-          }
-          num = cache[p-1][index];
-
-          if(debug) cout << "iter: " << GREEN << i << RESET << "  addr: " << GREEN << region << RESET <<"  index: " 
-            << GREEN << index << RESET << "  num: " << GREEN << num << RESET << endl;
-
-          if(max.size() < num_regions_needed) {
-            max.push_back(make_pair(num, region));
-          }else{
-            for(j=0; j<max.size(); j++) {
-              if(max[j].first < num) {
-                if(debug) cout << MAGENTA << "OLD" << RESET << "  index: " << GREEN << max[j].second 
-                  << RESET << "  num: " << GREEN << max[j].first << endl;
-                if(debug) cout << MAGENTA << "NEW" << RESET << "  index: " << GREEN << index << RESET 
-                  << "  num: " << GREEN << num << RESET << endl;
-                max[j] = make_pair(num, region);
-                break;
-              }
-            }
-          }
-          if(max.size() == num_regions_needed) {
-            for(j=0; j<max.size(); j++) {
-              if(max[j].first != (pow(2, counter_size[p])-1)){
-                if(debug) cout << "reg_bits: " << counter_size[p] << endl;
-                if(debug) cout << "max: " << (pow(2, counter_size[p])-1) << endl;
-                if(debug) cout << MAGENTA << "SMALL" << RESET << "  index: " << GREEN << max[j].second 
-                  << RESET << "  num: " << GREEN << max[j].first << RESET << endl;
-                if(debug) cout << endl;
-                break;  
-              }else if(j == max.size()-1){
-                if(debug) cout << MAGENTA << "BIG" << RESET << "  index: " << GREEN << max[j].second 
-                  << RESET << "  num: " << GREEN << max[j].first << RESET << endl;
-                done = true;
-                if(debug) cout << endl;
-              }
-            }
-          }
-          if(done){
-            break;
-          }
-        }
-        if(debug) {
-          cout << "Size: " << GREEN << max.size() << RESET << endl;
-          cout << "Max: ";
-          for(i=0; i<max.size(); i++) {
-            cout << "(" << GREEN << max[i].first << RESET << "," << MAGENTA << fixed << hex << max[i].second << RESET << ")  ";
-          }
-          cout << endl;
-        }
-
-        num_regions_per = region_size[p-1]/region_size[p];
-        index = 0;
-
-        //set up mmap
-        for(i=0; i<max.size(); i++) {
-          if(debug) cout << MAGENTA << "START: " << GREEN << fixed << hex << max[i].second << RESET << endl;
-          start_addr = max[i].second;
-          start_addr = start_addr>>mmap_region_zeros[p];
-          if(debug) cout << MAGENTA << "BEGIN: " << GREEN << start_addr << RESET << "  Hex: " 
-            << GREEN << fixed << hex << start_addr << RESET << endl;
-
-          //add sub regions to phase_3_mmap from single region in phase 1
-          for(k=0; k<num_regions_per; k++) {
-            mmap[p].insert(pair<uint64_t, uint64_t>(start_addr, index));
-
-            if(debug) cout << "Phase " << p << " mmap-> " << "Address: " << fixed << hex << start_addr
-              << ", " << dec << start_addr<<mmap_region_zeros[p] << " -- Cache_Index: " << fixed << hex << index
-                << ", " << dec << index << endl;
-
-            index++;
-            start_addr += 1;
-          }
-        }
-      }
-    }
-};
+/* export_interval: write the non-zero counters of every active phase
+ * Parameters: Exporter& the export stream
+ *             Global& the tracker
+ *             uint64_t the interval that just ended
+ *             double the timestamp it ended at
+ * Returns: None
+ */
+void export_interval(Exporter& X, Global& G, uint64_t iteration, double time) {
+  X.begin_interval(iteration, time, G.active_phases);
+  X.write_phase0(G);
+  for(int p=1; p<G.active_phases; p++) {
+    X.write_phase(p, G);
+  }
+}
 
 int main(int argc, char* argv[]) {
   int i;  //for looping
   int opt; 
   int ver = 0;
+  int stats = 0;
+  int oracle = 0;
+  char* export_name = nullptr;
+  string report_name = "-";
+  Report::Format format = Report::TABLE;
+  int use_color = 1;
+  char* checkpoint_name = nullptr;
+  uint64_t checkpoint_every = 10;
+  int resume = 0;
+  char* index_name = nullptr;
+  double start_time = -1;
+  double end_time = -1;
+  uint64_t window_begin = 0;
+  uint64_t window_end = (uint64_t)-1;
+  int windowed = 0;
+  TierSim Z;
+  IntervalPolicy P;
+  DamonEngine D;
+  Tenants A;
+  int type_column = -1; //trace column with r/w, -1 for none
+  int weight_column = -1; //trace column with a weight, -1 for none
+  int heat_set = 0;
+  HeatMode heat_mode = HEAT_COUNT;
+  uint64_t cost_read = 1;
+  uint64_t cost_write = 1;
+  char* shm_name = nullptr; //read records from a shared memory ring instead of the dataset
+  uint64_t shm_capacity = 1 << 20;
+  int parallel = 0; //worker threads for the offline two pass mode, 0 for off
+  uint64_t promote_threshold = 0; //misses before a region is promoted, 0 for off
+  HugePages::Mode huge_mode = HugePages::OFF;
+  TlbCounters TLB;
+  Sampler S;
+  Coalescer RL; //run length pre-aggregation
+  SlidingWindow SW;
+  Churn CH; //hot set changes per rebuild
+  Predictor PD; //seeds predicted regions into phases 1 and 2
   int uint64_t_index = 0;
-  float inter;
-  char* l1;
-  char* l2;
-  char* l3;
-  char* ds;
+  float inter = 0;
+  char* l1 = nullptr;
+  char* l2 = nullptr;
+  char* l3 = nullptr;
+  char* ds = nullptr;
   int p_interval = 0;
 
   static struct option uint64_t_options[] = {
@@ -406,6 +109,44 @@ int main(int argc, char* argv[]) {
     { "dataset",  required_argument,  0,  'd' },
     {"interval", 	required_argument,  0,  'i' },
     { "verbose", 	      no_argument,  0,  'v' },
+    {   "stats",        no_argument,  0,  's' },
+    {  "oracle",        no_argument,  0,  'o' },
+    {  "export",  required_argument,  0,  'e' },
+    {  "format",  required_argument,  0,  'f' },
+    {"no-color",        no_argument,  0,  'n' },
+    {  "report",  required_argument,  0,  'r' },
+    {"checkpoint",  required_argument,  0,  'k' },
+    {"checkpoint-every",  required_argument,  0,  'K' },
+    {  "resume",        no_argument,  0,  'R' },
+    {   "index",  required_argument,  0,  'x' },
+    {"start-time",  required_argument,  0,  'S' },
+    {"end-time",  required_argument,  0,  'E' },
+    {"intervals",  required_argument,  0,  'I' },
+    {"tier-capacity",  required_argument,  0,  'T' },
+    {"tier-latency",  required_argument,  0,  'L' },
+    {"tier-bandwidth",  required_argument,  0,  'B' },
+    {  "policy",  required_argument,  0,  'P' },
+    {   "damon",        no_argument,  0,  'D' },
+    {"damon-budget",  required_argument,  0,  'M' },
+    { "tenants",        no_argument,  0,  'A' },
+    {"tenant-column",  required_argument,  0,  'C' },
+    {"tenant-budget",  required_argument,  0,  'U' },
+    {"type-column",  required_argument,  0,  'y' },
+    {"weight-column",  required_argument,  0,  'w' },
+    {    "heat",  required_argument,  0,  'H' },
+    {    "cost",  required_argument,  0,  'F' },
+    {     "shm",  required_argument,  0,  'm' },
+    {"shm-capacity",  required_argument,  0,  'Q' },
+    {"parallel",  required_argument,  0,  'j' },
+    { "promote",  required_argument,  0,  'p' },
+    {"hugepages",  required_argument,  0,  'g' },
+    {     "tlb",        no_argument,  0,  't' },
+    {"tlb-walk-event",  required_argument,  0,  'W' },
+    {"sample-rate",  required_argument,  0,  'z' },
+    {"coalesce",        no_argument,  0,  'u' },
+    {  "window",  required_argument,  0,  'G' },
+    {   "churn",        no_argument,  0,  'h' },
+    { "predict",  required_argument,  0,  'q' },
     {         0,                  0,  0,   0  }
   };
 
@@ -420,13 +161,207 @@ int main(int argc, char* argv[]) {
   // put ':' in the starting of the 
   // string so that program can  
   //distinguish between '?' and ':'  
-  while((opt = getopt_long(argc, argv, ":a:b:c:d:i:v", uint64_t_options, &uint64_t_index)) != -1)  
+  while((opt = getopt_long(argc, argv, ":a:b:c:d:i:vsoe:f:nr:k:K:Rx:S:E:I:T:L:B:P:DM:AC:U:y:w:H:F:m:Q:j:p:g:tW:z:uG:hq:", uint64_t_options, &uint64_t_index)) != -1)  
   {  
     switch(opt)  
     {  
       case 'v':
         ver = 1;
         break;
+      case 's':
+        stats = 1;
+        break;
+      case 'o':
+        oracle = 1;
+        break;
+      case 'e':
+        export_name = optarg;
+        break;
+      case 'f':
+        if(!Report::parse_format(optarg, format)) {
+          printf("format must be table, csv or tsv\n");
+          exit(1);
+        }
+        break;
+      case 'n':
+        use_color = 0;
+        break;
+      case 'r':
+        report_name = optarg;
+        break;
+      case 'k':
+        checkpoint_name = optarg;
+        break;
+      case 'K':
+        checkpoint_every = strtoull(optarg, nullptr, 10);
+        if(checkpoint_every == 0) checkpoint_every = 1;
+        break;
+      case 'R':
+        resume = 1;
+        break;
+      case 'x':
+        index_name = optarg;
+        break;
+      case 'S':
+        start_time = atof(optarg);
+        windowed = 1;
+        break;
+      case 'E':
+        end_time = atof(optarg);
+        windowed = 1;
+        break;
+      case 'T': {
+        //bytes with an optional K, M or G suffix
+        char* end;
+        Z.capacity = strtoull(optarg, &end, 10);
+        if(*end == 'K' || *end == 'k') Z.capacity <<= 10;
+        else if(*end == 'M' || *end == 'm') Z.capacity <<= 20;
+        else if(*end == 'G' || *end == 'g') Z.capacity <<= 30;
+        Z.enabled = 1;
+        break;
+      }
+      case 'L':
+        if(sscanf(optarg, "%lf,%lf", &Z.fast_ns, &Z.slow_ns) != 2) {
+          printf("tier-latency must be fast_ns,slow_ns\n");
+          exit(1);
+        }
+        break;
+      case 'B':
+        if(sscanf(optarg, "%lf,%lf", &Z.fast_gbs, &Z.slow_gbs) != 2) {
+          printf("tier-bandwidth must be fast_GBs,slow_GBs\n");
+          exit(1);
+        }
+        break;
+      case 'P':
+        if(!P.parse(optarg)) {
+          printf("policy must be time, count:N, saturate[:PCT] or adaptive[:PCT[:OVERHEAD]]\n");
+          exit(1);
+        }
+        break;
+      case 'D':
+        D.enabled = 1;
+        break;
+      case 'M':
+        D.budget = strtoull(optarg, nullptr, 10);
+        D.enabled = 1;
+        break;
+      case 'A':
+        A.enabled = 1;
+        break;
+      case 'C':
+        A.column = atoi(optarg);
+        A.enabled = 1;
+        if(A.column < 2) {
+          printf("tenant-column must be 2 or more, 0 and 1 are time and address\n");
+          exit(1);
+        }
+        break;
+      case 'U':
+        A.budget = strtoull(optarg, nullptr, 10);
+        A.enabled = 1;
+        break;
+      case 'y':
+        type_column = atoi(optarg);
+        break;
+      case 'w':
+        weight_column = atoi(optarg);
+        break;
+      case 'H': {
+        string mode(optarg);
+        if(mode == "count") heat_mode = HEAT_COUNT;
+        else if(mode == "weighted") heat_mode = HEAT_WEIGHTED;
+        else if(mode == "separate") heat_mode = HEAT_SEPARATE;
+        else {
+          printf("heat must be count, weighted or separate\n");
+          exit(1);
+        }
+        heat_set = 1;
+        break;
+      }
+      case 'F': {
+        unsigned long long r, w;
+        if(sscanf(optarg, "%llu,%llu", &r, &w) != 2) {
+          printf("cost must be read,write\n");
+          exit(1);
+        }
+        cost_read = r;
+        cost_write = w;
+        break;
+      }
+      case 'm':
+        shm_name = optarg;
+        break;
+      case 'Q':
+        shm_capacity = strtoull(optarg, nullptr, 10);
+        break;
+      case 'g':
+        if(!HugePages::parse(optarg, huge_mode)) {
+          printf("hugepages must be off, thp or hugetlb\n");
+          exit(1);
+        }
+        break;
+      case 't':
+        TLB.enabled = 1;
+        break;
+      case 'W':
+        TLB.walk_event = strtoull(optarg, nullptr, 0);
+        TLB.enabled = 1;
+        break;
+      case 'u':
+        RL.enabled = 1;
+        break;
+      case 'h':
+        CH.enabled = 1;
+        break;
+      case 'q':
+        if(!PD.parse(optarg)) {
+          printf("predict must be last, stride or markov, with an optional :PICKS\n");
+          exit(1);
+        }
+        break;
+      case 'G':
+        SW.length = atof(optarg);
+        SW.enabled = 1;
+        if(SW.length <= 0) {
+          printf("window must be more than 0 seconds\n");
+          exit(1);
+        }
+        break;
+      case 'z':
+        S.rate = atof(optarg);
+        S.enabled = 1;
+        if(S.rate <= 0 || S.rate > 1) {
+          printf("sample-rate must be more than 0 and at most 1\n");
+          exit(1);
+        }
+        break;
+      case 'p':
+        promote_threshold = strtoull(optarg, nullptr, 10);
+        if(promote_threshold > MissFilter::MAX_THRESHOLD) {
+          printf("promote can be at most %llu misses\n", (unsigned long long)MissFilter::MAX_THRESHOLD);
+          exit(1);
+        }
+        break;
+      case 'j':
+        parallel = atoi(optarg);
+        if(parallel < 1) {
+          printf("parallel needs at least 1 thread\n");
+          exit(1);
+        }
+        break;
+      case 'I': {
+        //a:b is half open, either side may be left out
+        string range(optarg);
+        size_t colon = range.find(':');
+        if(colon == string::npos) {
+          printf("intervals must be a:b\n");
+          exit(1);
+        }
+        if(colon > 0) window_begin = strtoull(range.substr(0, colon).c_str(), nullptr, 10);
+        if(colon+1 < range.size()) window_end = strtoull(range.substr(colon+1).c_str(), nullptr, 10);
+        windowed = 1;
+        break;
+      }
       case 'i':  
         inter = atof(optarg);  
         break;  
@@ -457,34 +392,201 @@ int main(int argc, char* argv[]) {
     printf("extra arguments: %s\n", argv[optind]);  
   } 
 
+  //tables allocated from here on follow the huge page mode
+  HugePages::stats().mode = huge_mode;
+
   //initialize the cache
   Global G;
   G.init();	
 
+  if(!l1 || !l2 || !l3) {
+    cout << RED << "--L1, --L2 and --L3 are needed" << RESET << endl;
+    exit(1);
+  }
   G.parse(l1, l2, l3);
   G.interval = inter;
   G.verbose = ver;
-  string tmp_str(ds);
+  string tmp_str(ds ? ds : "");
   G.dataset_name = tmp_str;
-  p_interval = G.verbose;
+  if(!ds && !shm_name) {
+    cout << RED << "--dataset or --shm is needed" << RESET << endl;
+    exit(1);
+  }
+  p_interval = G.verbose || format != Report::TABLE;
 
   //set debugging to off
   G.debug = 0;
 
-  //mmap calculations
-  for(i=1; i<3; i++) {
-    G.mmap_cache_bits[i] = ceil(log2(G.num_cache_regions[i])); 
-    G.mmap_region_zeros[i] = ceil(log2(G.region_size[i]));
-    G.mmap_region_bits[i] = G.num_bits_addressable-G.mmap_region_zeros[i];
+  //optional timers and memory columns
+  Instrument T;
+  T.enabled = stats;
+
+  //mmap calculations and cache set up
+  if((type_column >= 0 && type_column < 2) || (weight_column >= 0 && weight_column < 2)) {
+    cout << RED << "type and weight columns must be 2 or more, 0 and 1 are time and address" << RESET << endl;
+    exit(1);
+  }
+  if(!heat_set && (type_column >= 0 || weight_column >= 0)) heat_mode = HEAT_WEIGHTED;
+  if(heat_mode == HEAT_SEPARATE && resume) {
+    cout << RED << "--heat separate can not be combined with --resume" << RESET << endl;
+    exit(1);
+  }
+  G.heat_mode = heat_mode;
+  G.cost_read = cost_read;
+  G.cost_write = cost_write;
+  G.promote_threshold = promote_threshold;
+  G.setup();
+  P.setup(G.interval);
+
+  //the index and checkpoints only know about time boundaries
+  if(P.kind != IntervalPolicy::TIME && (resume || windowed || index_name)) {
+    cout << RED << "--policy " << P.name() << " can not be combined with --resume, --index or a window" << RESET << endl;
+    exit(1);
+  }
+
+  //only the tracker is checkpointed, parts keeping their own state would restart empty
+  if(resume && (oracle || export_name || Z.enabled || D.enabled || SW.enabled || CH.enabled
+      || promote_threshold || S.enabled)) {
+    cout << RED << "--resume can not be combined with --oracle, --export, --tier-capacity, --damon, --window, --churn,"
+      << " --promote or --sample-rate" << RESET << endl;
+    exit(1);
+  }
+
+  //the two pass mode reads every interval's byte range out of the index
+  if(parallel && (shm_name || resume || windowed || checkpoint_name || A.enabled
+      || heat_mode != HEAT_COUNT || P.kind != IntervalPolicy::TIME)) {
+    cout << RED << "--parallel needs --policy time and --heat count, and can not be combined with --shm, --resume, --checkpoint, --tenants or a window" << RESET << endl;
+    exit(1);
+  }
+
+  //sampled runs find interval boundaries at sampled records only, so the
+  //index built from them would not match a full pass
+  if(S.enabled && (parallel || index_name || windowed)) {
+    cout << RED << "--sample-rate can not be combined with --parallel, --index or a window" << RESET << endl;
+    exit(1);
+  }
+  S.setup(S.rate, G.mmap_region_zeros[2]);
+
+  //held back accesses would hide saturation from the policy and carry no weight
+  if(RL.enabled && (heat_mode != HEAT_COUNT || (P.kind != IntervalPolicy::TIME && P.kind != IntervalPolicy::COUNT))) {
+    cout << RED << "--coalesce needs --heat count and --policy time or count" << RESET << endl;
+    exit(1);
+  }
+  RL.setup(G, parallel ? 1 : 0);
+
+  //optional exact counts at the finest phase granularity, it counts accesses
+  //so it can only score a tracker that ranks by accesses too
+  if(oracle && heat_mode != HEAT_COUNT) {
+    cout << RED << "--oracle needs --heat count" << RESET << endl;
+    exit(1);
+  }
+  Oracle O;
+  O.enabled = oracle;
+  O.setup(G.mmap_region_zeros[2], G.num_bits_addressable);
+
+  //optional sliding window of exact counts at the finest phase granularity
+  SW.setup(SW.length, G.mmap_region_zeros[2]);
+
+  //optional fast/slow tier placement of the finest phase hot regions
+  Z.setup(G.mmap_region_zeros[2]);
+
+  //the ring only carries time and address and has no byte offsets
+  ShmRing ring;
+  if(shm_name) {
+    string error;
+    if(resume || windowed || index_name || checkpoint_name || A.enabled || type_column >= 0 || weight_column >= 0) {
+      cout << RED << "--shm can not be combined with --resume, --checkpoint, --index, windows or extra columns" << RESET << endl;
+      exit(1);
+    }
+    if(!ring.create(shm_name, shm_capacity, error)) {
+      cout << RED << error << RESET << endl;
+      exit(1);
+    }
+    if(G.verbose) cout << CYAN << "Waiting on ring " << GREEN << shm_name << RESET
+      << " (" << GREEN << ring.size() << RESET << " records)" << endl;
   }
 
-  //finish cache set up
-  G.cache[0].resize(G.num_cache_regions[0]);
-  G.cache[1].resize(G.num_cache_regions[1]);
-  G.cache[2].resize(G.num_cache_regions[2]);
+  //optional tracker per pid/asid, copied from the fresh global tracker
+  if(A.enabled) {
+    if(resume) {
+      cout << RED << "--tenants can not be combined with --resume" << RESET << endl;
+      exit(1);
+    }
+    if(!A.setup(G)) {
+      cout << RED << "--tenant-budget " << A.budget << " can not hold one tenant and the overflow tracker, "
+        << 2*A.tenant_bytes << " bytes with these phases" << RESET << endl;
+      exit(1);
+    }
+  }
 
-  //set begining of address range
-  G.first_address_as_uint64_t = 0;
+  //optional predicted regions past each phase's own slots, tenants keep none
+  if(PD.enabled) {
+    if(resume) {
+      cout << RED << "--predict can not be combined with --resume" << RESET << endl;
+      exit(1);
+    }
+    PD.setup(G);
+  }
+
+  //optional variable size region engine beside the cascade
+  if(D.enabled) D.setup(G.num_bits_addressable, G.region_size[2]);
+
+  //optional binary stream of every interval's counters
+  Exporter X;
+  if(export_name && !X.open(export_name, G.num_bits_addressable, G.region_size, G.counter_size)) {
+    cout << RED << "could not open " << export_name << RESET << endl;
+    exit(1);
+  }
+
+  //pick up where an earlier run left off
+  Progress at = {0, 0, 0};
+  if(resume) {
+    string error;
+    if(!checkpoint_name) {
+      cout << RED << "--resume needs --checkpoint" << RESET << endl;
+      exit(1);
+    }
+    if(!load_checkpoint(G, at, checkpoint_name, error)) {
+      cout << RED << error << RESET << endl;
+      exit(1);
+    }
+  }
+
+  //find where the requested window starts, building the index if needed
+  IntervalIndex IX;
+  ParallelReader PR; //offline two pass mode, phase 0 counted ahead by worker threads
+  uint64_t interval_base = 0; //absolute number of the first interval read
+  int build_index = 0;
+  if(index_name) IX.load(index_name, G.dataset_name, G.interval);
+  if(windowed) {
+    if(resume) {
+      cout << RED << "--resume can not be combined with a window" << RESET << endl;
+      exit(1);
+    }
+    if(!IX.loaded) {
+      if(!IX.scan(G.dataset_name, G.interval)) {
+        cout << RED << "could not open " << G.dataset_name << RESET << endl;
+        exit(1);
+      }
+      if(index_name) IX.save(index_name, G.dataset_name, G.interval);
+    }
+    if(start_time >= 0) window_begin = IX.find_time(start_time);
+    if(window_begin >= IX.entries.size()) {
+      cout << RED << "window starts after the last interval (" << IX.entries.size() << ")" << RESET << endl;
+      exit(1);
+    }
+    interval_base = window_begin;
+  }else if(parallel) {
+    if(!IX.loaded) {
+      if(!IX.scan(G.dataset_name, G.interval)) {
+        cout << RED << "could not open " << G.dataset_name << RESET << endl;
+        exit(1);
+      }
+      if(index_name) IX.save(index_name, G.dataset_name, G.interval);
+    }
+  }else if(index_name && !IX.loaded && !resume) {
+    build_index = 1;
+  }
 
   //print variables
   if(G.verbose){
@@ -526,64 +628,186 @@ int main(int argc, char* argv[]) {
 
   //read dataset in from dataset file and run 
   string line;
-  uint64_t addr;
-  uint64_t index;
-  double time;
+  uint64_t addr = 0;
+  double time = 0;
   string phys_addr;
   stringstream iss;
   string token;
   int where;
-  double pause_time = 0;
-  bool first_time = true;
-  uint64_t iteration = 0;
+  double pause_time = at.pause_time;
+  bool first_time = !resume;
+  uint64_t iteration = at.iteration;
+  uint64_t offset = 0; //byte offset of the next line
+  uint64_t line_start = 0; //byte offset of the current line
+  bool window_done = false; //stopped at the end of --intervals
+  uint64_t boundary_ns = 0; //wall clock at the last boundary, adaptive policy only
+  uint64_t t_boundary = 0;
+  uint64_t rebuild_ns = 0; //how long the last rebuild took, adaptive policy only
+  uint64_t tenant = 0; //pid/asid of the current line, 0 if the column is missing
+  bool write = false; //current line is a write, reads if the column is missing
+  uint64_t weight = 1; //weight of the current line, 1 if the column is missing
+  uint64_t writes = 0;
+  uint64_t total_weight = 0;
   vector<float> percentage;
-  const string sep = " |";
-  const string sep_line = sep + string(100, '-') + '|';
+  uint64_t t_mark = 0; //clock at the end of the last counted access
+  uint64_t t_parsed = 0; //clock after the current line was parsed
+  bool label_row; //this row carries the interval number
 
   percentage.resize(4);
 
+  //all table and summary output goes through the buffered report writer
+  Report R;
+  cout.flush();
+  if(!R.open(report_name, format, use_color)) {
+    cout << RED << "could not open " << report_name << RESET << endl;
+    exit(1);
+  }
+  R.fixed2 = G.verbose;
+  //debug output goes straight to cout from inside the tracker, so rows must too
+  if(G.debug) R.synchronous();
+  R.add_column("Interval", "interval", 8);
+  R.add_column("Phase", "phase", 5);
+  R.add_column("Cache_Hit", "cache_hit", 10);
+  R.add_column("%", "hit_pct", 7);
+  R.add_column("Cache_Mis", "cache_miss", 10);
+  R.add_column("%", "miss_pct", 7);
+  R.add_column("Count_Inc", "count_inc", 10);
+  R.add_column("%", "inc_pct", 7);
+  R.add_column("Cnt_Full", "count_full", 10);
+  R.add_column("%", "full_pct", 7);
+  if(CH.enabled) {
+    R.add_column("Entered", "entered", 8);
+    R.add_column("Left", "left", 8);
+    R.add_column("Jaccard", "jaccard", 7);
+  }
+  if(stats) {
+    R.add_column("Acc/s", "acc_per_sec", 12);
+    R.add_column("Parse_ms", "parse_ms", 9);
+    R.add_column("Count_ms", "count_ms", 9);
+    R.add_column("Rebld_ms", "rebuild_ms", 9);
+    R.add_column("Cache_KB", "cache_kb", 10);
+    R.add_column("Mmap_KB", "mmap_kb", 10);
+    R.add_column("RSS_MB", "rss_mb", 8);
+  }
+  if(oracle) {
+    R.add_column("Prec", "precision", 6);
+    R.add_column("Recall", "recall", 6);
+    R.add_column("Cover%", "cover_pct", 7);
+    R.add_column("Best%", "best_pct", 7);
+  }
+  if(P.kind != IntervalPolicy::TIME) {
+    R.add_column("Policy", "ended_by", 6);
+    R.add_column("Len_s", "length_s", 8);
+    R.add_column("Accesses", "accesses", 10);
+  }
+  if(Z.enabled) {
+    R.add_column("Fast%", "fast_pct", 7);
+    R.add_column("Lat_ns", "avg_latency_ns", 8);
+    R.add_column("Promote", "promoted", 8);
+    R.add_column("Demote", "demoted", 8);
+  }
+  if(SW.enabled) {
+    R.add_column("Win_Reg", "window_regions", 8);
+    R.add_column("Win_Acc", "window_accesses", 10);
+    R.add_column("WTop%", "window_top_pct", 7);
+  }
+  if(promote_threshold) R.add_column("Miss_Pr", "miss_promoted", 8);
+  if(PD.enabled) {
+    R.add_column("Seeded", "seeded", 8);
+    R.add_column("Seed_Hit", "seeded_hits", 9);
+  }
+  if(D.enabled) R.add_column("Regions", "regions", 8);
+
   //if(G.verbose) cout << endl << endl << GREEN << "Start Run" 
   //  << RESET << endl;
-  if(p_interval) cout << RESET << sep_line << '\n' << sep
-                               << setw(8) << "Interval" << sep
-                               << setw(5) << "Phase" << sep
-                               << setw(10) << "Cache_Hit" << sep
-                               << setw(7) << "%" << sep
-                               << setw(10) << "Cache_Mis" << sep
-                               << setw(7) << "%" << sep
-                               << setw(10) << "Count_Inc" <<sep
-                               << setw(7) << "%" << sep
-                               << setw(10) << "Cnt_Full" << sep
-                               << setw(7) << "%" << sep
-                               << '\n' << sep_line << '\n';
+  if(p_interval) R.header();
 
   //read in dataset
-  ifstream myfile(G.dataset_name);
-  if(myfile.is_open()){
-    getline(myfile, line); //remove column names
-
-    //grab line
-    while(getline(myfile, line)){
-      iss << line;
-      where = 0;
-
-      //parse for ","
-      while(getline(iss, token, ',')){
-        if(where == 0){
-          time = stod(token, nullptr);
-        }else if(where == 1){
-          phys_addr = token;
+  ifstream myfile;
+  if(!shm_name) myfile.open(G.dataset_name);
+  if(shm_name || myfile.is_open()){
+    if(shm_name) {
+      offset = 0;
+    }else if(windowed) {
+      offset = IX.entries[window_begin].offset;
+      myfile.seekg(offset);
+      if(G.verbose) {
+        R.drain();
+        cout << CYAN << "Starting at interval " << GREEN << window_begin << RESET
+          << " byte " << GREEN << offset << RESET << endl;
+      }
+    }else if(resume) {
+      myfile.seekg(at.offset);
+      offset = at.offset;
+      if(G.verbose) {
+        R.drain();
+        cout << CYAN << "Resuming at interval " << GREEN << iteration << RESET
+          << " byte " << GREEN << offset << RESET << endl;
+      }
+    }else{
+      getline(myfile, line); //remove column names
+      offset = line.size()+1;
+    }
+    if(parallel) PR.open(G.dataset_name, IX, G, parallel);
+    if(TLB.open()) TLB.start();
+    T.start();
+    if(T.enabled) t_mark = T.now_ns();
+
+    //grab line, or the next record straight out of the ring or the parallel reader,
+    //the sampler reads past the lines it skips itself and hands back the address
+    while(shm_name ? ring.next(time, addr) : parallel ? PR.next(time, addr) :
+        S.enabled ? S.next_line(myfile, line, addr, offset) : (bool)getline(myfile, line)){
+      if(!shm_name && !parallel) {
+        line_start = offset;
+        offset += line.size()+1;
+        iss << line;
+        where = 0;
+
+        //parse for ","
+        while(getline(iss, token, ',')){
+          if(where == 0){
+            time = stod(token, nullptr);
+          }else if(where == 1){
+            phys_addr = token;
+          }else{
+            if(where == A.column && A.enabled) tenant = strtoull(token.c_str(), nullptr, 0);
+            if(where == type_column) write = (token[0] == 'W' || token[0] == 'w' || token[0] == 'S' || token[0] == 's' || token[0] == '1');
+            if(where == weight_column) weight = strtoull(token.c_str(), nullptr, 10);
+          }
+          where++;
         }
-        where++;
+        if(!S.enabled) addr = G.string_to_uint64_t(phys_addr);
+      }else if(S.enabled && shm_name && !S.keep(addr)) {
+        continue;
+      }
+      if(end_time >= 0 && time > end_time) break;
+      if(T.enabled) {
+        t_parsed = T.now_ns();
+        T.parse_ns += t_parsed - t_mark;
       }
 
       if(first_time){
         first_time = false;
-        pause_time = time + G.interval;
-      }else if(pause_time < time){
-        pause_time = time + G.interval;
+        pause_time = P.start(time);
+        if(build_index) IX.begin(time, line_start);
+        if(P.kind == IntervalPolicy::ADAPTIVE) boundary_ns = T.now_ns();
+      }else if(P.boundary(time, pause_time, G)){
+        if(RL.enabled) RL.flush(G);
+        if(parallel) PR.install(G, iteration);
+        if(P.kind == IntervalPolicy::ADAPTIVE) {
+          t_boundary = T.now_ns();
+          pause_time = P.next(time, G, rebuild_ns, t_boundary - boundary_ns);
+          boundary_ns = t_boundary;
+        }else{
+          pause_time = P.next(time, G, 0, 0);
+        }
+        if(build_index) IX.begin(time, line_start);
         //if(p_interval) cout << CYAN << "##########  Iteration: " << GREEN << iteration << RESET
         //  << "   Timestamp: " << GREEN << time << RESET << endl;
+        if(O.enabled) O.score(G.mmap[2], G.num_cache_regions[2], G.active_phases == 3);
+        if(X.enabled) export_interval(X, G, interval_base + iteration, time);
+        if(Z.enabled) Z.end_interval();
+        if(SW.enabled) SW.slide(time);
         for(i=0; i<3; i++) {
           //only print phase_1
           if(iteration==0 && i==1) break;
@@ -597,70 +821,167 @@ int main(int argc, char* argv[]) {
             percentage[2] = ((float)G.counter_inc[i]/(G.counter_inc[i]+G.counter_dec[i]))*100;
             percentage[3] = ((float)G.counter_dec[i]/(G.counter_inc[i]+G.counter_dec[i]))*100;
 
-            cout << RESET << sep;
+            label_row = (iteration<2) ? (i==0) : (i==1);
+            R.begin_row();
+            R.label(interval_base + iteration, label_row);
+            R.cell((uint64_t)i);
+            R.cell(S.scaled(G.cache_hits[i]));
+            R.cell(percentage[0], 2, percentage[0]>50 ? GREEN : RED);
+            R.cell(S.scaled(G.cache_misses[i]));
+            R.cell(percentage[1], 2, percentage[1]>50 ? GREEN : RED);
+            R.cell(S.scaled(G.counter_inc[i]));
+            R.cell(percentage[2], 2, percentage[2]>50 ? GREEN : RED);
+            R.cell(S.scaled(G.counter_dec[i]));
+            R.cell(percentage[3], 2, percentage[3]>50 ? GREEN : RED);
+
+            //the churn of the rebuild that picked this interval's hot set
+            if(CH.enabled) {
+              if(i > 0 && CH.valid(i)) {
+                R.cell(CH.phases[i].entered);
+                R.cell(CH.phases[i].left);
+                R.cell(CH.phases[i].jaccard, 3);
+              }else{
+                R.blank();
+                R.blank();
+                R.blank();
+              }
+            }
 
-            if(iteration<2) {
-              if(i==0) {
-                cout << setw(8) << iteration << sep;
+            if(stats) {
+              if(label_row || format != Report::TABLE) {
+                R.cell(T.accesses_per_sec(), 0);
+                R.cell(T.parse_ns/1e6, 2);
+                R.cell(T.count_ns/1e6, 2);
+                R.cell(T.rebuild_ns/1e6, 2);
+              }else{
+                R.blank();
+                R.blank();
+                R.blank();
+                R.blank();
+              }
+              R.cell(G.counter_bytes(i)/1024);
+              R.cell(Instrument::map_bytes(G.mmap[i])/1024);
+              R.label(Instrument::peak_rss_bytes()/1048576, label_row);
+            }
+            if(oracle) {
+              if(i == 2 && O.scored) {
+                R.cell(O.precision, 2);
+                R.cell(O.recall, 2);
+                R.cell(O.coverage, 2);
+                R.cell(O.best_coverage, 2);
               }else{
-                cout << setw(8) << " " << sep;
+                R.blank();
+                R.blank();
+                R.blank();
+                R.blank();
               }
-            }else {
-              if(i==1) {
-                cout << setw(8) << iteration << sep;
+            }
+            if(P.kind != IntervalPolicy::TIME) {
+              if(label_row || format != Report::TABLE) {
+                R.cell(P.ended_by);
+                R.cell(P.duration, 3);
+                R.cell(P.accesses);
+              }else{
+                R.blank();
+                R.blank();
+                R.blank();
+              }
+            }
+            if(Z.enabled) {
+              if(i == 2) {
+                R.cell(Z.fast_fraction, 2);
+                R.cell(Z.avg_latency, 1);
+                R.cell(Z.promoted);
+                R.cell(Z.demoted);
               }else{
-                cout << setw(8) << " " << sep;
+                R.blank();
+                R.blank();
+                R.blank();
+                R.blank();
               }
             }
-            
-            cout << setw(5) << i << sep
-                 << setw(10) << G.cache_hits[i] << sep;
-            
-            if(percentage[0]>50){
-              cout << GREEN << setprecision(2) << setw(7) <<  percentage[0] << sep;
-            }else{
-              cout << RED << setprecision(2) << setw(7) << percentage[0] << sep;
+            if(SW.enabled) {
+              //the window is whole from the first interval, so use its last row
+              if(i == (iteration < 2 ? (int)iteration : 2)) {
+                R.cell((uint64_t)SW.totals.size());
+                R.cell(SW.accesses);
+                R.cell(SW.top_coverage(G.num_cache_regions[2]), 2);
+              }else{
+                R.blank();
+                R.blank();
+                R.blank();
+              }
             }
-           
-            cout << RESET << setw(10) << G.cache_misses[i] << sep;
-            
-            if(percentage[1]>50){
-              cout << GREEN << setprecision(2) << setw(7) <<  percentage[1] << sep;
-            }else{
-              cout << RED << setprecision(2) << setw(7) << percentage[1] << sep;
-            }     
-              
-            cout << RESET << setw(10) << G.counter_inc[i] <<sep;
-            
-            if(percentage[2]>50){
-              cout << GREEN << setprecision(2) << setw(7) <<  percentage[2] << sep;
-            }else{
-              cout << RED << setprecision(2) << setw(7) << percentage[2] << sep;
+            if(promote_threshold) {
+              if(i > 0) R.cell(G.promoted[i]);
+              else R.blank();
             }
-                 
-            cout << RESET << setw(10) << G.counter_dec[i] << sep;
-            
-            if(percentage[3]>50){
-              cout << GREEN << setprecision(2) << setw(7) <<  percentage[3] << sep;
-            }else{
-              cout << RED << setprecision(2) << setw(7) << percentage[3] << sep;
+            if(PD.enabled) {
+              if(i > 0) {
+                R.cell(G.seeded[i]);
+                R.cell(G.seeded_hits[i]);
+              }else{
+                R.blank();
+                R.blank();
+              }
             }
-            cout << RESET << '\n';
+            if(D.enabled) R.blank();
+            R.end_row();
           }
           G.total_cache_hits[i] += G.cache_hits[i];
           G.total_cache_misses[i] += G.cache_misses[i];
           G.total_counter_inc[i] += G.counter_inc[i];
           G.total_counter_dec[i] += G.counter_dec[i];
+          PD.total_seeded_hits[i] += G.seeded_hits[i];
         }
-        if(p_interval) cout << sep_line << '\n';
+
+        //the region engine gets its own row in the same format, phase D
+        if(D.enabled) {
+          if(p_interval) {
+            uint64_t seen = D.cache_hits + D.cache_misses;
+            uint64_t updates = D.counter_inc + D.counter_dec;
+            percentage[0] = seen ? ((float)D.cache_hits/seen)*100 : 0;
+            percentage[1] = seen ? ((float)D.cache_misses/seen)*100 : 0;
+            percentage[2] = updates ? ((float)D.counter_inc/updates)*100 : 0;
+            percentage[3] = updates ? ((float)D.counter_dec/updates)*100 : 0;
+            R.begin_row();
+            R.label(interval_base + iteration, false);
+            R.cell("D");
+            R.cell(D.cache_hits);
+            R.cell(percentage[0], 2, percentage[0]>50 ? GREEN : RED);
+            R.cell(D.cache_misses);
+            R.cell(percentage[1], 2, percentage[1]>50 ? GREEN : RED);
+            R.cell(D.counter_inc);
+            R.cell(percentage[2], 2, percentage[2]>50 ? GREEN : RED);
+            R.cell(D.counter_dec);
+            R.cell(percentage[3], 2, percentage[3]>50 ? GREEN : RED);
+            R.blank_until(1);
+            R.cell((uint64_t)D.regions.size());
+            R.end_row();
+          }
+          D.end_interval();
+          D.clear_interval();
+        }
+        if(A.enabled) A.end_interval();
+        if(p_interval) R.rule();
         iteration++;
 
+        //stop once the last interval of the window is done
+        if(interval_base + iteration >= window_end) {
+          window_done = true;
+          break;
+        }
+
+        //the next interval runs on this interval's hottest regions
+        if(Z.enabled) Z.place(G, G.active_phases == 3);
+
         //clear counters
         for(i=0; i<3; i++) {
           G.cache_hits[i] = 0;
           G.cache_misses[i] = 0;
           G.counter_inc[i] = 0;
           G.counter_dec[i] = 0;
+          G.seeded_hits[i] = 0;
         }
 
         //quit early
@@ -671,38 +992,63 @@ int main(int argc, char* argv[]) {
         }
 
         //do a heatmaping of the current caches and cascade
+        T.end_interval();
+        if(PD.enabled) PD.observe(G);
         G.heatmap(iteration);
+        //churn compares the picks, before the predictor adds its seeds to the index
+        if(CH.enabled) {
+          for(i=1; i<G.active_phases; i++) CH.update(i, G.mmap[i]);
+        }
+        if(PD.enabled) PD.seed(G);
+        if(P.kind == IntervalPolicy::ADAPTIVE) rebuild_ns = T.now_ns() - t_boundary;
+        if(T.enabled) {
+          t_parsed = T.now_ns();
+          T.add_rebuild(t_parsed - T.interval_start_ns);
+        }
 
+        //the current line is the first of the new interval
+        if(checkpoint_name && iteration % checkpoint_every == 0) {
+          Progress now = {iteration, line_start, pause_time};
+          if(!save_checkpoint(G, now, checkpoint_name)) {
+            R.drain();
+            cout << RED << "could not write checkpoint " << checkpoint_name << RESET << endl;
+          }
+        }
       }
 
       //change counters for this access
       if(G.debug) cout << RESET << "Timestamp: " << GREEN << time << MAGENTA << " seconds" << RESET << endl;
-      addr = G.string_to_uint64_t(phys_addr);
       if(G.debug) cout << RESET << "Address-- Hex:" << GREEN << fixed << hex << addr << RESET << "  uint64_t: " 
         << GREEN << dec << addr << RESET << endl;
 
       //add to phase_cache counter
-      for(i=2; i>-1; i--) {
-        //only run phase1 on first interval
-        if(iteration==0) {
-          i=0;
-          //only run phase 1, 2 on second interval
-        }else if(iteration==1 && i==2) {
-          i=1;
-        }
-
-        if(G.debug) cout << MAGENTA << "Phase_" << i << " ->" << RESET << endl;
-        index = G.find_offset(i, addr);
-        if(index != (uint64_t)-1) {
-          G.cache_hits[i]++;
-          if(G.change_counter(i, index)){
-            G.counter_inc[i]++;
-          }else{
-            G.counter_dec[i]++;
-          }
-        }else{
-          G.cache_misses[i]++;
-        }
+      if(build_index) IX.entries.back().records++;
+      if(RL.enabled) {
+        RL.add(G, addr);
+      }else if(parallel) {
+        G.record_refine(addr);
+      }else if(heat_mode == HEAT_COUNT) {
+        G.record(addr);
+      }else{
+        G.record_weighted(addr, write, weight);
+        if(write) writes++;
+        total_weight += weight;
+      }
+      if(O.enabled) O.add(addr);
+      if(S.enabled) S.count(addr);
+      if(Z.enabled) Z.access(addr);
+      if(SW.enabled) SW.access(addr);
+      if(D.enabled) D.access(addr);
+      if(A.enabled) {
+        A.record(tenant, addr, write, weight);
+        tenant = 0;
+      }
+      write = false;
+      weight = 1;
+      if(T.enabled) {
+        t_mark = T.now_ns();
+        T.count_ns += t_mark - t_parsed;
+        T.accesses++;
       }
       if(G.debug) cout << endl;
       if(G.debug) cout << RESET << endl;
@@ -710,24 +1056,323 @@ int main(int argc, char* argv[]) {
     }
   }
   myfile.close();	
+  TLB.stop();
+
+  //only a complete pass from the start describes the whole dataset
+  if(build_index && !IX.save(index_name, G.dataset_name, G.interval)) {
+    R.drain();
+    cout << RED << "could not write index " << index_name << RESET << endl;
+  }
 
-  cout << endl;
-  cout << CYAN << "Total Stats:" << RESET << endl;
+  //the last interval never reaches a boundary so export it here
+  if(RL.enabled) RL.flush(G);
+  if(parallel && !first_time) PR.install(G, iteration);
+  if(X.enabled) {
+    if(!first_time && !window_done) export_interval(X, G, interval_base + iteration, time);
+    X.close();
+  }
+  if(Z.enabled && !first_time && !window_done) Z.end_interval();
+  if(SW.enabled && !first_time && !window_done) SW.slide(time);
+  if(CH.enabled) CH.finish();
+
+  R.summary("\n");
+  if(P.kind != IntervalPolicy::TIME) {
+    R.summary("%sInterval Policy:%s %s%s%s\n", R.c(CYAN), R.c(RESET), R.c(GREEN), P.name(), R.c(RESET));
+    if(P.kind == IntervalPolicy::COUNT) R.summary("Accesses: %s%llu%s\n", R.c(GREEN), (unsigned long long)P.count, R.c(RESET));
+    if(P.kind == IntervalPolicy::SATURATE) {
+      R.summary("Saturation_target: %s%g%s%%%s  Min_accesses: %s%llu%s\n", R.c(GREEN), P.saturation, R.c(MAGENTA), R.c(RESET),
+        R.c(GREEN), (unsigned long long)P.min_accesses, R.c(RESET));
+    }
+    if(P.kind == IntervalPolicy::ADAPTIVE) {
+      R.summary("Saturation_target: %s%g%s%%%s  Overhead_target: %s%g%s%%%s  Final_interval: %s%g%s s%s\n",
+        R.c(GREEN), P.saturation, R.c(MAGENTA), R.c(RESET),
+        R.c(GREEN), P.overhead, R.c(MAGENTA), R.c(RESET),
+        R.c(GREEN), P.length, R.c(MAGENTA), R.c(RESET));
+    }
+  }
+  //sampled runs print every count scaled up by the sampler's estimate
+  R.summary("%sTotal Stats:%s\n", R.c(CYAN), R.c(RESET));
   for(int i=0; i<3; i++) {
-    cout << "Phase " << i << endl;
-    cout << "Total_cache_hits: " << GREEN << G.total_cache_hits[i] << RESET << "  Percentage: " 
-      << MAGENTA << ((float)G.total_cache_hits[i]/(G.total_cache_hits[i]+G.total_cache_misses[i]))*100 
-      << "%" << RESET << endl;
-    cout << "Total_cache_misses: " << GREEN << G.total_cache_misses[i] << RESET << "  Percentage: " 
-      << MAGENTA << ((float)G.total_cache_misses[i]/(G.total_cache_hits[i]+G.total_cache_misses[i]))*100 
-      << "%" << RESET << endl;
-    cout << "Total_counter_inc: " << GREEN << G.total_counter_inc[i] << RESET << "  Percentage: " 
-      << MAGENTA << ((float)G.total_counter_inc[i]/(G.total_counter_inc[i]+G.total_counter_dec[i]))*100 
-      << "%" << RESET << endl;
-    cout << "Total_counter_not_inc: " << GREEN << G.total_counter_dec[i] << RESET << "  Percentage: " 
-      << MAGENTA << ((float)G.total_counter_dec[i]/(G.total_counter_inc[i]+G.total_counter_dec[i]))*100 
-      << "%" << RESET << endl;
+    R.summary("Phase %d\n", i);
+    R.summary("Total_cache_hits: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)S.scaled(G.total_cache_hits[i]), R.c(RESET), R.c(MAGENTA),
+      R.pct(((float)G.total_cache_hits[i]/(G.total_cache_hits[i]+G.total_cache_misses[i]))*100), R.c(RESET));
+    R.summary("Total_cache_misses: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)S.scaled(G.total_cache_misses[i]), R.c(RESET), R.c(MAGENTA),
+      R.pct(((float)G.total_cache_misses[i]/(G.total_cache_hits[i]+G.total_cache_misses[i]))*100), R.c(RESET));
+    R.summary("Total_counter_inc: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)S.scaled(G.total_counter_inc[i]), R.c(RESET), R.c(MAGENTA),
+      R.pct(((float)G.total_counter_inc[i]/(G.total_counter_inc[i]+G.total_counter_dec[i]))*100), R.c(RESET));
+    R.summary("Total_counter_not_inc: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)S.scaled(G.total_counter_dec[i]), R.c(RESET), R.c(MAGENTA),
+      R.pct(((float)G.total_counter_dec[i]/(G.total_counter_inc[i]+G.total_counter_dec[i]))*100), R.c(RESET));
+  }
+
+  if(stats) {
+    uint64_t run_ns = Instrument::now_ns() - T.run_start_ns;
+    T.end_interval();
+    R.summary("%sInstrumentation:%s\n", R.c(CYAN), R.c(RESET));
+    R.summary("Accesses: %s%llu%s  Accesses/sec: %s%.0f%s\n", R.c(GREEN), (unsigned long long)T.total_accesses,
+      R.c(RESET), R.c(MAGENTA), run_ns ? T.total_accesses*1e9/run_ns : 0.0, R.c(RESET));
+    R.summary("Parse_time: %s%.2f%s ms%s  Count_time: %s%.2f%s ms%s\n", R.c(GREEN), T.total_parse_ns/1e6,
+      R.c(MAGENTA), R.c(RESET), R.c(GREEN), T.total_count_ns/1e6, R.c(MAGENTA), R.c(RESET));
+    R.summary("Rebuilds: %s%zu%s  p50: %s%.2f%s ms%s  p99: %s%.2f%s ms%s\n", R.c(GREEN), T.rebuilds.size(),
+      R.c(RESET), R.c(GREEN), T.rebuild_percentile(50)/1e6, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), T.rebuild_percentile(99)/1e6, R.c(MAGENTA), R.c(RESET));
+    R.summary("Peak_RSS: %s%llu%s MB%s  Output_backlog_peak: %s%llu%s Bytes%s\n", R.c(GREEN),
+      (unsigned long long)(Instrument::peak_rss_bytes()/1048576), R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), (unsigned long long)R.backlog_peak(), R.c(MAGENTA), R.c(RESET));
+  }
+
+  if(export_name) {
+    R.summary("%sExport:%s\n", R.c(CYAN), R.c(RESET));
+    R.summary("Intervals: %s%llu%s  Entries: %s%llu%s  Bytes: %s%llu%s\n",
+      R.c(GREEN), (unsigned long long)X.intervals_written, R.c(RESET),
+      R.c(GREEN), (unsigned long long)X.entries_written, R.c(RESET),
+      R.c(GREEN), (unsigned long long)X.bytes_written, R.c(RESET));
+  }
+
+  if(D.enabled) {
+    uint64_t seen = D.total_cache_hits + D.total_cache_misses;
+    uint64_t updates = D.total_counter_inc + D.total_counter_dec;
+    R.summary("Phase D\n");
+    R.summary("Total_cache_hits: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)D.total_cache_hits, R.c(RESET), R.c(GREEN), R.pct(seen ? ((float)D.total_cache_hits/seen)*100 : 0), R.c(RESET));
+    R.summary("Total_cache_misses: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)D.total_cache_misses, R.c(RESET), R.c(GREEN), R.pct(seen ? ((float)D.total_cache_misses/seen)*100 : 0), R.c(RESET));
+    R.summary("Total_counter_inc: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)D.total_counter_inc, R.c(RESET), R.c(GREEN), R.pct(updates ? ((float)D.total_counter_inc/updates)*100 : 0), R.c(RESET));
+    R.summary("Total_counter_not_inc: %s%llu%s  Percentage: %s%s%%%s\n", R.c(GREEN),
+      (unsigned long long)D.total_counter_dec, R.c(RESET), R.c(GREEN), R.pct(updates ? ((float)D.total_counter_dec/updates)*100 : 0), R.c(RESET));
+    R.summary("Regions: %s%zu%s  Peak: %s%llu%s  Budget: %s%llu%s (%s%llu%s Bytes%s)  Smallest: %s%llu%s Bytes%s\n",
+      R.c(GREEN), D.regions.size(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)D.peak_regions, R.c(RESET),
+      R.c(GREEN), (unsigned long long)D.max_regions, R.c(RESET),
+      R.c(GREEN), (unsigned long long)D.budget, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), (unsigned long long)(D.smallest == ~0ULL ? 0 : D.smallest), R.c(MAGENTA), R.c(RESET));
+    R.summary("Splits: %s%llu%s  Merges: %s%llu%s\n",
+      R.c(GREEN), (unsigned long long)D.total_splits, R.c(RESET),
+      R.c(GREEN), (unsigned long long)D.total_merges, R.c(RESET));
+  }
+
+  if(RL.enabled) {
+    R.summary("%sCoalesce:%s Accesses: %s%llu%s  Table_updates: %s%llu%s  Accesses/update: %s%.2f%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), (unsigned long long)RL.accesses, R.c(RESET),
+      R.c(GREEN), (unsigned long long)RL.updates, R.c(RESET),
+      R.c(MAGENTA), RL.updates ? (double)RL.accesses/RL.updates : 0.0, R.c(RESET));
+  }
+
+  if(PD.enabled) {
+    R.summary("%sPrediction:%s %s%s%s  Picks: %s%llu%s / %s%llu%s per rebuild\n", R.c(CYAN), R.c(RESET),
+      R.c(GREEN), PD.name(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)PD.budget[1], R.c(RESET),
+      R.c(GREEN), (unsigned long long)PD.budget[2], R.c(RESET));
+    for(int p=1; p<3; p++) {
+      uint64_t seen = G.total_cache_hits[p] + G.total_cache_misses[p];
+      double seeded = PD.rebuilds[p] ? (double)PD.total_seeded[p]/PD.rebuilds[p] : 0;
+      double with = seen ? 100.0*G.total_cache_hits[p]/seen : 0;
+      double without = seen ? 100.0*(G.total_cache_hits[p] - PD.total_seeded_hits[p])/seen : 0;
+      R.summary("Phase %d  Seeded: %s%.1f%s regions/rebuild (%s%.2f%s%% extra)  Seed_hits: %s%llu%s  Hit_rate: %s%.2f%s%% from %s%.2f%s%% (%s%+.2f%s points)\n", p,
+        R.c(GREEN), seeded, R.c(RESET),
+        R.c(MAGENTA), 100.0*seeded/G.num_cache_regions[p], R.c(RESET),
+        R.c(GREEN), (unsigned long long)PD.total_seeded_hits[p], R.c(RESET),
+        R.c(GREEN), with, R.c(RESET),
+        R.c(GREEN), without, R.c(RESET),
+        R.c(MAGENTA), with - without, R.c(RESET));
+    }
+  }
+
+  if(CH.enabled) {
+    R.summary("%sChurn:%s\n", R.c(CYAN), R.c(RESET));
+    for(int p=1; p<3; p++) {
+      Churn::Phase& ph = CH.phases[p];
+      string buckets;
+      char bucket[64];
+      int last = Churn::BUCKETS-1;
+
+      R.summary("Phase %d  Rebuilds: %s%llu%s  Entered: %s%llu%s  Left: %s%llu%s  Mean_jaccard: %s%.3f%s  Mean_lifetime: %s%.2f%s rebuilds%s\n", p,
+        R.c(GREEN), (unsigned long long)ph.rebuilds, R.c(RESET),
+        R.c(GREEN), (unsigned long long)ph.total_entered, R.c(RESET),
+        R.c(GREEN), (unsigned long long)ph.total_left, R.c(RESET),
+        R.c(GREEN), ph.rebuilds ? ph.sum_jaccard/ph.rebuilds : 0.0, R.c(RESET),
+        R.c(GREEN), ph.runs ? (double)ph.run_rebuilds/ph.runs : 0.0, R.c(MAGENTA), R.c(RESET));
+
+      //lifetime histogram up to the longest run, buckets are [low, 2*low)
+      while(last > 0 && ph.lifetimes[last] == 0) last--;
+      for(int b=0; b<=last; b++) {
+        uint64_t low = Churn::bucket_low(b);
+        if(b == Churn::BUCKETS-1) snprintf(bucket, sizeof(bucket), "  %llu+: ", (unsigned long long)low);
+        else if(low == 1) snprintf(bucket, sizeof(bucket), "  1: ");
+        else snprintf(bucket, sizeof(bucket), "  %llu-%llu: ", (unsigned long long)low, (unsigned long long)(2*low-1));
+        buckets += bucket;
+        buckets += R.c(GREEN);
+        buckets += to_string(ph.lifetimes[b]);
+        buckets += R.c(RESET);
+      }
+      R.summary("Lifetimes:%s\n", buckets.c_str());
+    }
+  }
+
+  if(SW.enabled) {
+    R.summary("%sSliding Window:%s %s%g%s s  Intervals: %s%llu%s  Regions: %s%zu%s  Accesses: %s%llu%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), SW.length, R.c(RESET),
+      R.c(GREEN), (unsigned long long)SW.intervals(), R.c(RESET),
+      R.c(GREEN), SW.totals.size(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)SW.accesses, R.c(RESET));
+    R.summary("Top_%llu_coverage: %s%.2f%s%%%s  Hottest: %s0x%llx%s\n", (unsigned long long)G.num_cache_regions[2],
+      R.c(GREEN), SW.top_coverage(G.num_cache_regions[2]), R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), (unsigned long long)SW.hottest(), R.c(RESET));
+    R.summary("Slides: %s%llu%s  Entries/slide: %s%.1f%s  Peak_intervals: %s%llu%s  Peak_regions: %s%llu%s\n",
+      R.c(GREEN), (unsigned long long)SW.slides, R.c(RESET),
+      R.c(MAGENTA), SW.slides ? (double)SW.entries_applied/SW.slides : 0.0, R.c(RESET),
+      R.c(GREEN), (unsigned long long)SW.peak_intervals, R.c(RESET),
+      R.c(GREEN), (unsigned long long)SW.peak_regions, R.c(RESET));
+  }
+
+  if(S.enabled) {
+    uint64_t counted = S.counted();
+    double bound = S.bound();
+    R.summary("%sSampling:%s rate %s%g%s  Records_read: %s%llu%s  Sampled: %s%llu%s  Regions: %s%zu%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), S.rate, R.c(RESET),
+      R.c(GREEN), (unsigned long long)S.seen, R.c(RESET),
+      R.c(GREEN), (unsigned long long)counted, R.c(RESET),
+      R.c(GREEN), S.regions.size(), R.c(RESET));
+    R.summary("Estimated_accesses: %s%.0f%s +/- %s%.0f%s (95%%, %s%.2f%s%%)  Scale: %s%.2f%s\n",
+      R.c(GREEN), S.estimate(counted), R.c(RESET), R.c(GREEN), bound, R.c(RESET),
+      R.c(MAGENTA), counted ? bound/S.estimate(counted)*100 : 0.0, R.c(RESET),
+      R.c(GREEN), S.estimate(1), R.c(RESET));
+  }
+
+  if(huge_mode != HugePages::OFF) {
+    HugePages::Stats& hs = HugePages::stats();
+    R.summary("%sHuge Pages:%s %s%s%s  Hugetlb: %s%llu%s KB  Advised: %s%llu%s KB  Node_pool: %s%llu%s KB  Fallbacks: %s%llu%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), HugePages::name(huge_mode), R.c(RESET),
+      R.c(GREEN), (unsigned long long)hs.hugetlb_bytes/1024, R.c(RESET),
+      R.c(GREEN), (unsigned long long)hs.thp_bytes/1024, R.c(RESET),
+      R.c(GREEN), (unsigned long long)hs.pool_bytes/1024, R.c(RESET),
+      R.c(GREEN), (unsigned long long)hs.fallbacks, R.c(RESET));
+    R.summary("AnonHugePages: %s%llu%s KB\n", R.c(GREEN), (unsigned long long)HugePages::anon_huge_bytes()/1024, R.c(RESET));
+  }
+
+  if(TLB.enabled) {
+    uint64_t seen = G.total_cache_hits[0] + G.total_cache_misses[0];
+    const char* names[TlbCounters::COUNTERS] = {"dTLB_load_misses", "dTLB_store_misses", "Page_walks"};
+    R.summary("%sTLB:%s\n", R.c(CYAN), R.c(RESET));
+    for(int c=0; c<TlbCounters::COUNTERS; c++) {
+      if(TLB.available(c)) {
+        R.summary("%s: %s%llu%s  Per_1k_accesses: %s%.2f%s\n", names[c], R.c(GREEN), (unsigned long long)TLB.value[c], R.c(RESET),
+          R.c(MAGENTA), seen ? TLB.value[c]*1000.0/seen : 0.0, R.c(RESET));
+      }else if(c != TlbCounters::PAGE_WALKS || TLB.walk_event) {
+        R.summary("%s: %sunavailable%s %s\n", names[c], R.c(RED), R.c(RESET), TLB.error.c_str());
+      }
+    }
+  }
+
+  if(shm_name) {
+    R.summary("%sRing:%s %s%s%s  Records: %s%llu%s  Dropped: %s%llu%s  Producer_stalls: %s%llu%s  Consumer_waits: %s%llu%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), shm_name, R.c(RESET),
+      R.c(GREEN), (unsigned long long)ring.consumed(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)ring.dropped(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)ring.stalls(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)ring.waits, R.c(RESET));
+  }
+
+  if(promote_threshold) {
+    R.summary("%sMiss Promotion:%s threshold %s%llu%s misses\n", R.c(CYAN), R.c(RESET),
+      R.c(GREEN), (unsigned long long)promote_threshold, R.c(RESET));
+    for(int i=1; i<3; i++) {
+      R.summary("Phase %d  Promoted: %s%llu%s regions\n", i, R.c(GREEN), (unsigned long long)G.total_promoted[i], R.c(RESET));
+    }
+  }
+
+  if(parallel) {
+    R.summary("%sParallel:%s %s%d%s threads  Intervals: %s%zu%s  Batch: %s%llu%s  Index: %s%s%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), PR.threads, R.c(RESET),
+      R.c(GREEN), IX.entries.size(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)PR.batch_intervals, R.c(RESET),
+      R.c(GREEN), IX.loaded ? "loaded" : "scanned", R.c(RESET));
+  }
+
+  if(heat_mode != HEAT_COUNT) {
+    const char* mode = heat_mode == HEAT_SEPARATE ? "separate" : "weighted";
+    R.summary("%sHeat:%s %s%s%s  Cost: %s%llu%s read %s%llu%s write  Writes: %s%llu%s  Total_weight: %s%llu%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), mode, R.c(RESET),
+      R.c(GREEN), (unsigned long long)cost_read, R.c(RESET),
+      R.c(GREEN), (unsigned long long)cost_write, R.c(RESET),
+      R.c(GREEN), (unsigned long long)writes, R.c(RESET),
+      R.c(GREEN), (unsigned long long)total_weight, R.c(RESET));
+  }
+
+  if(A.enabled) {
+    uint64_t accesses = 0, hot = 0;
+    vector<Tenants::Tenant*> order;
+    for(auto& t : A.tenants) {
+      accesses += t->accesses;
+      hot += t->G.total_cache_hits[2];
+      order.push_back(t.get());
+    }
+    sort(order.begin(), order.end(), [](Tenants::Tenant* a, Tenants::Tenant* b) { return a->accesses > b->accesses; });
+    R.summary("%sTenants:%s %s%zu%s  Overflowed: %s%llu%s  Budget: %s%llu%s Bytes%s  Per_tenant: %s%llu%s Bytes%s\n",
+      R.c(CYAN), R.c(RESET), R.c(GREEN), A.tenants.size(), R.c(RESET),
+      R.c(GREEN), (unsigned long long)A.overflowed, R.c(RESET),
+      R.c(GREEN), (unsigned long long)A.budget, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), (unsigned long long)A.tenant_bytes, R.c(MAGENTA), R.c(RESET));
+    for(auto t : order) {
+      char id[32];
+      if(t->id == Tenants::OVERFLOW) snprintf(id, sizeof(id), "other");
+      else snprintf(id, sizeof(id), "%llu", (unsigned long long)t->id);
+      R.summary("Tenant %s%s%s  Accesses: %s%llu%s (%.2f%%)  Hot_hits: %s%llu%s (%.2f%% of all hot)  Hot_regions: %s%zu%s (%s%llu%s Bytes%s)\n",
+        R.c(GREEN), id, R.c(RESET),
+        R.c(GREEN), (unsigned long long)t->accesses, R.c(RESET), accesses ? 100.0*t->accesses/accesses : 0,
+        R.c(GREEN), (unsigned long long)t->G.total_cache_hits[2], R.c(RESET), hot ? 100.0*t->G.total_cache_hits[2]/hot : 0,
+        R.c(GREEN), t->G.mmap[2].size(), R.c(RESET),
+        R.c(GREEN), (unsigned long long)(t->G.mmap[2].size()*t->G.region_size[2]), R.c(MAGENTA), R.c(RESET));
+    }
+  }
+
+  if(oracle) {
+    uint64_t counter_bytes = 0;
+    uint64_t index_bytes = 0;
+    for(i=0; i<3; i++) {
+      counter_bytes += G.cache_size[i];
+      index_bytes += G.num_cache_regions[i]*ceil((G.mmap_region_bits[i]+G.mmap_cache_bits[i])/8.0);
+    }
+    R.summary("%sOracle:%s\n", R.c(CYAN), R.c(RESET));
+    R.summary("Intervals_scored: %s%llu%s\n", R.c(GREEN), (unsigned long long)O.intervals_scored, R.c(RESET));
+    if(O.intervals_scored) {
+      R.summary("Mean_precision: %s%.3f%s  Mean_recall: %s%.3f%s\n",
+        R.c(GREEN), O.sum_precision/O.intervals_scored, R.c(RESET),
+        R.c(GREEN), O.sum_recall/O.intervals_scored, R.c(RESET));
+      R.summary("Mean_coverage: %s%.2f%s%%%s  Best_possible: %s%.2f%s%%%s\n",
+        R.c(GREEN), O.sum_coverage/O.intervals_scored, R.c(MAGENTA), R.c(RESET),
+        R.c(GREEN), O.sum_best_coverage/O.intervals_scored, R.c(MAGENTA), R.c(RESET));
+    }
+    R.summary("Counter_state: %s%llu%s Bytes%s  Index_state: %s%llu%s Bytes%s  Exact_state_peak: %s%llu%s Bytes%s\n",
+      R.c(GREEN), (unsigned long long)counter_bytes, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), (unsigned long long)index_bytes, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), (unsigned long long)O.peak_exact_bytes, R.c(MAGENTA), R.c(RESET));
+  }
+
+  if(Z.enabled) {
+    uint64_t accesses = Z.total_fast + Z.total_slow;
+    double latency = accesses ? (Z.total_fast*Z.fast_ns + Z.total_slow*Z.slow_ns + Z.total_migration_ns)/accesses : 0;
+    R.summary("%sTiered Memory:%s\n", R.c(CYAN), R.c(RESET));
+    R.summary("Fast_capacity: %s%llu%s Bytes%s  Regions: %s%llu%s  Latency: %s%g/%g%s ns%s  Bandwidth: %s%g/%g%s GB/s%s\n",
+      R.c(GREEN), (unsigned long long)Z.capacity, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), (unsigned long long)Z.slots, R.c(RESET),
+      R.c(GREEN), Z.fast_ns, Z.slow_ns, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), Z.fast_gbs, Z.slow_gbs, R.c(MAGENTA), R.c(RESET));
+    R.summary("Fast_fraction: %s%.2f%s%%%s  Avg_latency: %s%.1f%s ns%s  All_slow: %s%.1f%s ns%s\n",
+      R.c(GREEN), accesses ? 100.0*Z.total_fast/accesses : 0, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), latency, R.c(MAGENTA), R.c(RESET),
+      R.c(GREEN), Z.slow_ns, R.c(MAGENTA), R.c(RESET));
+    R.summary("Promoted: %s%llu%s  Demoted: %s%llu%s  Migration: %s%.2f%s ms%s\n",
+      R.c(GREEN), (unsigned long long)Z.total_promoted, R.c(RESET),
+      R.c(GREEN), (unsigned long long)Z.total_demoted, R.c(RESET),
+      R.c(GREEN), Z.total_migration_ns/1e6, R.c(MAGENTA), R.c(RESET));
   }
 
+  ring.close();
+  R.close();
   exit(0);
 }
@@ -0,0 +1,793 @@
+/* File: heatmap.h
+ * Author: Zach McMichael
+ * Description: the Global tracker class shared by the heatmap
+ *				binary and the benchmark suite
+ */
+
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <utility>
+#include <math.h>
+#include "miss_filter.h"
+#include "hugepage.h"
+#include "counters.h"
+
+#define RESET   "\033[0m"     
+#define RED     "\033[31m" 
+#define GREEN   "\033[32m" 
+#define MAGENTA "\033[35m" 
+#define CYAN    "\033[36m"
+
+using namespace std;
+
+//compile time trace policies for the per access path, Quiet compiles the
+//debug prints out of find_offset, increment and change_counter entirely
+struct Quiet { static constexpr bool trace = false; };
+struct Trace { static constexpr bool trace = true; };
+
+//how an access adds to a counter: by one, by its cost, or by its weight
+//into separate read and write counters that heatmap() ranks by cost
+enum HeatMode { HEAT_COUNT, HEAT_WEIGHTED, HEAT_SEPARATE };
+
+//the tracker over any counter backend in counters.h, Global below is the one
+//everything outside bench uses
+template<class Backend>
+class BasicGlobal {
+
+  public:
+    //hard coded vars
+    int debug; //for extra prints for debugging
+    int num_bits_addressable; //the number of bits needed to address the entire mem space
+
+    //passed in parameters
+    float interval; //ammount of time between heatmaping the data
+    int verbose; //extra prints
+    string dataset_name; //name of the dataset
+
+    //for creating the map from the dataset
+    uint64_t first_address_as_uint64_t;
+
+    //for calculating correctness per interval
+    vector<uint64_t> cache_hits; //number of cache hits
+    vector<uint64_t> cache_misses; //number of cache misses
+    vector<uint64_t> counter_inc; //number of time a counter in the cache was incremented
+    vector<uint64_t> counter_dec; //number of time a counter in the cache was not incremented
+    
+    //for calculating correctness overall
+    vector<uint64_t> total_cache_hits; //number of cache hits
+    vector<uint64_t> total_cache_misses; //number of cache misses
+    vector<uint64_t> total_counter_inc; //number of time a counter in the cache was incremented
+    vector<uint64_t> total_counter_dec; //number of time a counter in the cache was not incremented
+
+    //datastructures for cache
+    vector<int> num_region_bits; //number of bits needed to address all addresses in region
+    vector<int> counter_size; //size of the number of bits in for the counter in the cache
+    vector<uint64_t> cache_size; //size of the cache in bits
+    vector<uint64_t> total_data_size; //size of the total amount of data
+    vector<uint64_t> region_size; //size of each region
+    vector<uint64_t> num_cache_regions; //number of regions
+    typedef typename Backend::Table Table;
+    vector<Table> cache; //the cache for phase 1, 2, 3
+    vector<uint64_t> counter_max; //largest value a counter can hold per phase
+    vector<uint64_t> full; //counters at counter_max per phase, both tables with HEAT_SEPARATE
+    int region_shift_0; //log2 of the phase 0 region size
+    int active_phases; //phases counted this interval, grows 1, 2, 3 during warm up
+    void (BasicGlobal::*record_fn)(uint64_t) = nullptr; //record specialization for debug and active_phases
+
+    //typed and weighted accounting
+    HeatMode heat_mode = HEAT_COUNT;
+    uint64_t cost_read = 1; //cost of one read
+    uint64_t cost_write = 1; //cost of one write
+    vector<Table> wcache; //write counters, HEAT_SEPARATE only
+
+    //miss path promotion, phases 1 and 2 remember the regions they keep missing
+    uint64_t promote_threshold = 0; //misses before a region can be promoted, 0 for off
+    vector<MissFilter> miss; //per phase, phase 0 never misses
+    vector<uint64_t> promoted; //regions promoted into each phase at the last rebuild
+    vector<uint64_t> total_promoted;
+
+    //predicted regions seeded past a phase's own slots after a rebuild
+    vector<uint64_t> extra_regions; //slots kept past num_cache_regions for seeds, 0 for off
+    vector<uint64_t> seeded; //regions seeded into each phase at the last rebuild
+    vector<uint64_t> seeded_hits; //hits this interval that only a seeded region caught
+
+    //datastructures for memory map
+    vector<int> mmap_cache_bits; //number of bits needed in the mmap to offset into the cache
+    vector<int> mmap_region_bits; //number of bits needed in the mmap to figure out which region this beuint64_ts to
+    vector<int> mmap_region_zeros; //number of bits needed in the mmap to pad the address with zeros
+    vector<RegionIndex> mmap; //the memory map for phase 2, 3
+    RegionIndex::iterator mmap_itter; //iterator for the mmap
+
+    //##### helper functions #####
+
+    /* get_log2_size: 
+     * Parameters: uint64_t the number to figure out the size of
+     * Returns: pair<string, string> the number reduced by the type, the type
+     */
+    pair<string, string> get_log2_size(uint64_t num) {
+      string s_num;
+      string s_type;
+      if(num > pow(2,49)) {
+        cout << "Size is invalid" << endl;
+        exit(1);
+      }else if(num > pow(2, 39)) {
+        s_num = to_string(num/1000000000000);
+        s_type = " Terabytes";
+        return make_pair(s_num, s_type);
+      }else if(num > pow(2, 29)) {
+        s_num = to_string(num/1000000000);
+        s_type = " Gigabytes";
+        return make_pair(s_num, s_type);
+      }else if(num > pow(2, 19)) {
+        s_num = to_string(num/1000000);
+        s_type = " Megabytes";
+        return make_pair(s_num, s_type);
+      }else if(num > pow(2, 9)) {
+        s_num = to_string(num/1000);
+        s_type = " Kilobytes";
+        return make_pair(s_num, s_type);
+      }else {
+        s_num = to_string(num);
+        s_type = " Bytes";
+        return make_pair(s_num, s_type);
+      }
+    }
+
+    /* string_to_uint64_t: Converts an address as a string to a uint64_t
+     * Parameters: string the address to convert
+     * Returns: uint64_t the address as a number
+     */
+    uint64_t string_to_uint64_t(string address) {
+      stringstream ss;
+      uint64_t address_uint64_t;
+
+      ss << hex << address;
+      ss >> address_uint64_t;
+      return address_uint64_t;
+    }
+
+    /* increment: increment the counter by one if it is not maxed
+     * Parameters: int the phase you are on 
+     *             uint64_t the index in the cache to increment
+     * Returns: int 1 if incremented 0 if full
+     */
+    template<class Policy>
+    int increment(int phase, uint64_t offset) {
+      uint64_t value = Backend::get(cache[phase], offset);
+
+      if(value < counter_max[phase]){
+        Backend::set(cache[phase], offset, ++value);
+        if(value == counter_max[phase]) full[phase]++;
+        if(Policy::trace) cout << "Counter: " << GREEN << value << RESET << endl;
+        return 1;
+      }else{
+        return 0;
+      }
+    }
+
+    int increment(int phase, uint64_t offset) {
+      return debug ? increment<Trace>(phase, offset) : increment<Quiet>(phase, offset);
+    }
+
+    /* find_offset: find the offset at the specified address for the phase
+     * Parameters: int the phase you are on
+     *             uint64_t the address of the index we need to find
+     * Returns: uint64_t the index
+     */
+    template<class Policy>
+    uint64_t find_offset(int phase, uint64_t address_uint64_t) {
+      uint64_t offset = 0;
+
+      if(phase == 0) {
+        //region sizes are powers of two so the divide is a shift
+        return address_uint64_t >> region_shift_0;
+      }else{
+        //convert address to bitset for lookup in mmap
+        if(Policy::trace) cout << "Address uint64_t: " << address_uint64_t << "  Address Hex: " 
+          << hex << address_uint64_t << dec << endl;
+        address_uint64_t = address_uint64_t >> mmap_region_zeros[phase];
+
+        //find in mmap and convert from bitset to uint64_t
+        auto found = mmap[phase].find(address_uint64_t);
+        if(found == mmap[phase].end()) {
+          if(Policy::trace) cout << RED << "Address not found in mmap" << RESET << endl;
+          return -1;
+        }else{
+          offset = found->second;
+          if(Policy::trace) cout << GREEN << "Address found--  Index" << GREEN << offset << RESET << endl;
+          return offset;
+        }
+      }
+      return -1;
+    }
+
+    uint64_t find_offset(int phase, uint64_t address_uint64_t) {
+      return debug ? find_offset<Trace>(phase, address_uint64_t) : find_offset<Quiet>(phase, address_uint64_t);
+    }
+
+    //##### main functions #####
+
+    /* init: initilize the maps and vectors
+     * Parameters: None
+     * Returns: None
+     */
+    void init() {
+      //for calculating correctness per interval
+      cache_hits.resize(3);
+      cache_misses.resize(3);
+      counter_inc.resize(3);
+      counter_dec.resize(3);
+      
+      //for calculating total correctness
+      total_cache_hits.resize(3);
+      total_cache_misses.resize(3);
+      total_counter_inc.resize(3);
+      total_counter_dec.resize(3);
+
+      //datastructures for cache
+      num_region_bits.resize(3);
+      counter_size.resize(3);
+      cache_size.resize(3);
+      total_data_size.resize(3);
+      region_size.resize(3);
+      num_cache_regions.resize(3);
+      cache.resize(3);
+
+      //datastructures for memory map
+      mmap_cache_bits.resize(3);
+      mmap_region_bits.resize(3);
+      mmap_region_zeros.resize(3);
+      mmap.resize(3);
+      counter_max.resize(3);
+      full.resize(3);
+      wcache.resize(3);
+      miss.resize(3);
+      promoted.resize(3);
+      total_promoted.resize(3);
+      extra_regions.resize(3);
+      seeded.resize(3);
+      seeded_hits.resize(3);
+    }
+
+    /* parse: parse the L1, L2, L3 args
+     * Parameters: char* layer1
+     *             char* layer2
+     *             char* layer3
+     * Returns: None
+     */
+    void parse(char* l1, char* l2, char* l3) {
+      int i;
+      int data_bits, region_bits;
+      string tmp_str;
+      string l1_str(l1);
+      string l2_str(l2);
+      string l3_str(l3);
+      stringstream l1_s_str(l1_str);
+      stringstream l2_s_str(l2_str);
+      stringstream l3_s_str(l3_str);
+      vector<stringstream *> l;
+
+      l.push_back(&l1_s_str);
+      l.push_back(&l2_s_str);
+      l.push_back(&l3_s_str);
+
+      for(i=0; i<3; i++) {
+        getline((*(l[i])), tmp_str, ',');
+        data_bits = stol(tmp_str);
+        getline((*(l[i])), tmp_str, ',');
+        region_bits = stol(tmp_str);
+        getline((*(l[i])), tmp_str, ',');
+        set_phase(i, data_bits, region_bits, stol(tmp_str));
+      }
+    }
+
+    /* set_phase: size one phase, what parse does for each --L argument
+     * Parameters: int the phase
+     *             int log2 of the data the phase covers
+     *             int log2 of the region size
+     *             int bits per counter
+     * Returns: None
+     */
+    void set_phase(int i, int data_bits, int region_bits, int bits) {
+      if(i==0) num_bits_addressable = data_bits;
+      num_region_bits[i] = data_bits;
+      total_data_size[i] = pow(2, data_bits);
+      region_size[i] = pow(2, region_bits);
+      counter_size[i] = bits;
+      num_cache_regions[i] = total_data_size[i]/region_size[i];
+      cache_size[i] = num_cache_regions[i]*((float)counter_size[i]/8);
+    }
+
+    /* setup: derive the mmap bit widths and size the caches once parse has run
+     * Parameters: None
+     * Returns: None
+     */
+    void setup() {
+      int i;
+
+      //mmap calculations
+      for(i=1; i<3; i++) {
+        mmap_cache_bits[i] = ceil(log2(num_cache_regions[i])); 
+        mmap_region_zeros[i] = ceil(log2(region_size[i]));
+        mmap_region_bits[i] = num_bits_addressable-mmap_region_zeros[i];
+      }
+
+      //finish cache set up
+      for(i=0; i<3; i++) {
+        Backend::reset(cache[i], num_cache_regions[i], counter_size[i]);
+        if(heat_mode == HEAT_SEPARATE) Backend::reset(wcache[i], num_cache_regions[i], counter_size[i]);
+        counter_max[i] = pow(2, counter_size[i])-1;
+        full[i] = 0;
+      }
+      region_shift_0 = log2(region_size[0]);
+      set_phases(1);
+
+      //a candidate is one region of the phase above, what heatmap() picks
+      if(promote_threshold) {
+        for(i=1; i<3; i++) miss[i].setup(log2(region_size[i-1]), promote_threshold);
+      }
+
+      //set begining of address range
+      first_address_as_uint64_t = 0;
+    }
+
+    /* change_counter increment the counter in the cache of the desired phase
+     * Parameters: int the phase to be incremented
+     *             uint64_t the index into the cache
+     * Returns: bool if counter was incremented ret 1 if full ret 0
+     */
+    template<class Policy>
+    bool change_counter(int phase, uint64_t offset) {
+      if(increment<Policy>(phase, offset)) {
+        if(Policy::trace) cout << "Phase " << phase << "  Offset: " << hex << offset 
+          << "  Counter: " << dec << Backend::get(cache[phase], offset) << endl;
+        return true;
+      }else{
+        if(Policy::trace) cout << "Phase " << phase << "  Offset: " << hex << offset 
+          << "  Counter: " << dec << Backend::get(cache[phase], offset) << RED <<"  --FULL--" 
+            << RESET << endl;
+        return false;
+      }
+      return false;
+    }
+
+    bool change_counter(int phase, uint64_t offset) {
+      return debug ? change_counter<Trace>(phase, offset) : change_counter<Quiet>(phase, offset);
+    }
+
+    /* count_phase: count one access against a single phase
+     * Parameters: uint64_t the address that was accessed
+     * Returns: None
+     */
+    template<class Policy, int P>
+    void count_phase(uint64_t addr) {
+      uint64_t index;
+
+      if(Policy::trace) cout << MAGENTA << "Phase_" << P << " ->" << RESET << endl;
+      index = find_offset<Policy>(P, addr);
+      if(index != (uint64_t)-1) {
+        cache_hits[P]++;
+        if constexpr (P > 0) {
+          if(index >= num_cache_regions[P]) seeded_hits[P]++;
+        }
+        if(change_counter<Policy>(P, index)){
+          counter_inc[P]++;
+        }else{
+          counter_dec[P]++;
+        }
+      }else{
+        cache_misses[P]++;
+        if constexpr (P > 0) {
+          if(promote_threshold) miss[P].miss(addr);
+        }
+      }
+    }
+
+    /* record_phases: count one access against the first PHASES phases, the
+     *                phase loop is unrolled at compile time
+     * Parameters: uint64_t the address that was accessed
+     * Returns: None
+     */
+    template<class Policy, int PHASES>
+    void record_phases(uint64_t addr) {
+      if constexpr (PHASES > 2) count_phase<Policy, 2>(addr);
+      if constexpr (PHASES > 1) count_phase<Policy, 1>(addr);
+      count_phase<Policy, 0>(addr);
+    }
+
+    /* record: count a single access in every active phase through the
+     *         specialization set_phases picked, no per access branching
+     * Parameters: uint64_t the address that was accessed
+     * Returns: None
+     */
+    void record(uint64_t addr) {
+      (this->*record_fn)(addr);
+    }
+
+    template<class Policy>
+    void select_record() {
+      switch(active_phases) {
+        case 1: record_fn = &BasicGlobal::record_phases<Policy, 1>; break;
+        case 2: record_fn = &BasicGlobal::record_phases<Policy, 2>; break;
+        default: record_fn = &BasicGlobal::record_phases<Policy, 3>; break;
+      }
+    }
+
+    /* record_refine: count a single access in the active phases above phase
+     *                0, for when phase 0 was histogrammed ahead of time
+     * Parameters: uint64_t the address that was accessed
+     * Returns: None
+     */
+    void record_refine(uint64_t addr) {
+      if(active_phases > 2) count_phase<Quiet, 2>(addr);
+      if(active_phases > 1) count_phase<Quiet, 1>(addr);
+    }
+
+    /* add_count: saturating add of a run of accesses to one counter, the
+     *            inc/full split is the same as n single increments
+     * Parameters: int the phase
+     *             uint64_t the index in the cache
+     *             uint64_t accesses in the run
+     * Returns: None
+     */
+    void add_count(int phase, uint64_t index, uint64_t n) {
+      uint64_t value = Backend::get(cache[phase], index);
+      uint64_t room = counter_max[phase] - value;
+      uint64_t inc = (n < room) ? n : room;
+
+      if(inc) Backend::set(cache[phase], index, value + inc);
+      if(inc && inc == room) full[phase]++;
+      counter_inc[phase] += inc;
+      counter_dec[phase] += n - inc;
+    }
+
+    /* record_count: count a run of accesses to one finest phase region in
+     *               every active phase from first up
+     * Parameters: uint64_t an address in the region
+     *             uint64_t accesses in the run
+     *             int the first phase to count, 1 when phase 0 was counted ahead
+     * Returns: None
+     */
+    void record_count(uint64_t addr, uint64_t n, int first) {
+      uint64_t index;
+      int p;
+
+      for(p=active_phases-1; p>=first; p--) {
+        index = find_offset<Quiet>(p, addr);
+        if(index == (uint64_t)-1) {
+          cache_misses[p] += n;
+          if(promote_threshold) miss[p].miss(addr, n);
+          continue;
+        }
+        cache_hits[p] += n;
+        if(index >= num_cache_regions[p]) seeded_hits[p] += n;
+        add_count(p, index, n);
+      }
+    }
+
+    /* record_weighted: count one typed and weighted access in every active
+     *                  phase, counters add the amount and saturate, the
+     *                  inc/full counts stay per access whatever the amount
+     * Parameters: uint64_t the address that was accessed
+     *             bool the access was a write
+     *             uint64_t its weight, the sampling period for sampled traces
+     * Returns: None
+     */
+    void record_weighted(uint64_t addr, bool write, uint64_t weight) {
+      uint64_t index;
+      uint64_t amount;
+      int p;
+
+      amount = (heat_mode == HEAT_SEPARATE) ? weight : weight*(write ? cost_write : cost_read);
+      for(p=active_phases-1; p>=0; p--) {
+        index = find_offset<Quiet>(p, addr);
+        if(index == (uint64_t)-1) {
+          cache_misses[p]++;
+          if(promote_threshold) miss[p].miss(addr);
+          continue;
+        }
+        cache_hits[p]++;
+        if(index >= num_cache_regions[p]) seeded_hits[p]++;
+        Table& table = (heat_mode == HEAT_SEPARATE && write) ? wcache[p] : cache[p];
+        uint64_t value = Backend::get(table, index);
+        if(value < counter_max[p]) {
+          value = (amount < counter_max[p]-value) ? value+amount : counter_max[p];
+          Backend::set(table, index, value);
+          if(value == counter_max[p]) full[p]++;
+          counter_inc[p]++;
+        }else{
+          counter_dec[p]++;
+        }
+      }
+    }
+
+    /* heat: the value heatmap() ranks a region by, what anything outside the
+     *       tracker that ranks or reports regions should read
+     * Parameters: int the phase
+     *             uint64_t the index in the cache
+     * Returns: uint64_t the count, or the read and write cost with HEAT_SEPARATE
+     */
+    uint64_t heat(int phase, uint64_t index) const {
+      if(heat_mode != HEAT_SEPARATE) return Backend::get(cache[phase], index);
+      return cost_read*Backend::get(cache[phase], index) + cost_write*Backend::get(wcache[phase], index);
+    }
+
+    /* counter: read one read counter through the backend, for code that
+     *          saves or restores the table and should not know how it is stored
+     * Parameters: int the phase
+     *             uint64_t the index in the cache
+     * Returns: uint64_t the count
+     */
+    uint64_t counter(int phase, uint64_t index) const {
+      return Backend::get(cache[phase], index);
+    }
+
+    void set_counter(int phase, uint64_t index, uint64_t value) {
+      if(Backend::get(cache[phase], index) >= counter_max[phase]) full[phase]--;
+      Backend::set(cache[phase], index, value);
+      if(Backend::get(cache[phase], index) >= counter_max[phase]) full[phase]++;
+    }
+
+    //counters a phase's table holds, seed slots included
+    uint64_t counters(int phase) const {
+      return Backend::size(cache[phase]);
+    }
+
+    //bytes a phase's tables hold, the write table included with HEAT_SEPARATE
+    uint64_t counter_bytes(int phase) const {
+      if(heat_mode != HEAT_SEPARATE) return Backend::bytes(cache[phase]);
+      return Backend::bytes(cache[phase]) + Backend::bytes(wcache[phase]);
+    }
+
+    /* full_counters: how many of a phase's counters can not count any higher,
+     *                kept up to date as counters change so it costs nothing
+     * Parameters: int the phase
+     * Returns: pair<uint64_t, uint64_t> full counters, counters in use
+     */
+    pair<uint64_t, uint64_t> full_counters(int phase) const {
+      int tables = (heat_mode == HEAT_SEPARATE) ? 2 : 1;
+
+      //phases 1 and 2 only use the slots a region was given
+      return make_pair(full[phase], tables*(phase ? (uint64_t)mmap[phase].size() : counters(phase)));
+    }
+
+    //empty a phase's table and size it for n counters
+    void reset_counters(int phase, uint64_t n) {
+      Backend::reset(cache[phase], n, counter_size[phase]);
+      full[phase] = 0;
+    }
+
+    /* promote: add the miss candidates of a phase to the regions picked for
+     *          it, replacing the coldest pick when there is no room
+     * Parameters: int the phase being rebuilt
+     *             vector<pair<uint64_t, uint64_t>>& (count, region address) picked from the phase above
+     *             uint64_t regions the phase can hold
+     * Returns: uint64_t regions promoted
+     */
+    uint64_t promote(int p, vector<pair<uint64_t, uint64_t>>& max, uint64_t needed) {
+      uint64_t moved = 0;
+      uint64_t misses, region;
+      size_t j, coldest;
+      bool picked;
+
+      for(auto& c : miss[p].candidates) {
+        region = c.first << miss[p].shift;
+        misses = (c.second < counter_max[p-1]) ? c.second : counter_max[p-1];
+        picked = false;
+        coldest = 0;
+        for(j=0; j<max.size(); j++) {
+          if(max[j].second == region) {
+            picked = true;
+            break;
+          }
+          if(max[j].first < max[coldest].first) coldest = j;
+        }
+        if(picked) continue;
+        if(max.size() < needed) {
+          max.push_back(make_pair(misses, region));
+        }else if(!max.empty() && max[coldest].first < misses) {
+          max[coldest] = make_pair(misses, region);
+        }else{
+          continue;
+        }
+        moved++;
+      }
+      return moved;
+    }
+
+    /* seed: track a predicted region in a phase past its own slots, after
+     *       heatmap() rebuilt it
+     * Parameters: int the phase
+     *             uint64_t the region number in the phase
+     *             uint64_t the count it starts with
+     * Returns: bool false if it was tracked already or there is no room
+     */
+    bool seed(int p, uint64_t region, uint64_t count) {
+      uint64_t index = num_cache_regions[p] + seeded[p];
+
+      if(seeded[p] >= extra_regions[p]) return false;
+      if(!mmap[p].insert(make_pair(region, index)).second) return false;
+      Backend::set(cache[p], index, (count < counter_max[p]) ? count : counter_max[p]);
+      if(count >= counter_max[p]) full[p]++;
+      seeded[p]++;
+      return true;
+    }
+
+    /* set_iteration: pick how many phases are active for an iteration
+     * Parameters: uint64_t what iteration we are on
+     * Returns: None
+     */
+    void set_iteration(uint64_t iteration) {
+      //only phase 1 on the first interval, phase 1, 2 on the second
+      set_phases((iteration < 2) ? iteration+1 : 3);
+    }
+
+    /* set_phases: set the active phases and pick the record specialization
+     *             for them, debug is read here so set it before setup
+     * Parameters: int how many phases are counted
+     * Returns: None
+     */
+    void set_phases(int phases) {
+      active_phases = phases;
+      if(debug) {
+        select_record<Trace>();
+      }else{
+        select_record<Quiet>();
+      }
+    }
+
+    /* heatmap: runs through and moves counters to next phase
+     * Parameters: uint64_t what iteration we are on
+     * Returns: None
+     */
+    void heatmap(uint64_t iteration) {
+      int p; //for looping
+      uint64_t i, j, k;
+      bool done = false;
+      typedef pair<uint64_t, uint64_t> pairs; //to add to sets (the number, the index)
+      vector<pairs> max; //maximum number found
+      uint64_t index = 0;
+      uint64_t region = 0;
+      uint64_t num; //number to check size of 
+      uint64_t num_regions_needed; //number of regions needed to fill the next phase
+      uint64_t num_regions_per; //number of subregions per over region
+      uint64_t start_addr; //starting address for region
+
+      set_iteration(iteration);
+      for(p=2; p>-1; p--) {
+        //only run phase1 on first interval
+        if(iteration==0) {
+          p=0;
+          //only run phase 1, 2 on second interval
+        }else if(iteration==1 && p==2) {
+          p=1;
+        }
+
+        //clear mmap and cache
+        Backend::reset(cache[p], num_cache_regions[p] + extra_regions[p], counter_size[p]);
+        if(heat_mode == HEAT_SEPARATE) Backend::reset(wcache[p], num_cache_regions[p] + extra_regions[p], counter_size[p]);
+        full[p] = 0;
+        if(p>0) mmap[p].clear();
+        seeded[p] = 0;
+        max.clear();
+        done = false;
+
+        if(p==0) {
+          break;
+        }
+
+        //calculate number of regions to accuire
+        num_regions_needed = total_data_size[p]/region_size[p-1];
+
+        //set iterator to begining
+        if(p>1) mmap_itter = (mmap[p-1]).begin();
+
+        //find hot regions in the above phase, seeded ones included
+        for(i=0; i<num_cache_regions[p-1] + extra_regions[p-1]; i++) {
+          if(p==1) {
+            region = (region_size[p-1])*i;
+            index = i;
+          }else if(p>1) {
+            if(mmap_itter == mmap[p-1].end()) break;
+            region = mmap_itter->first;
+            region = region << mmap_region_zeros[p-1];
+            index = mmap_itter->second;
+            mmap_itter++;
+          }
+          num = heat(p-1, index);
+
+          if(debug) cout << "iter: " << GREEN << i << RESET << "  addr: " << GREEN << region << RESET <<"  index: " 
+            << GREEN << index << RESET << "  num: " << GREEN << num << RESET << endl;
+
+          if(max.size() < num_regions_needed) {
+            max.push_back(make_pair(num, region));
+          }else{
+            for(j=0; j<max.size(); j++) {
+              if(max[j].first < num) {
+                if(debug) cout << MAGENTA << "OLD" << RESET << "  index: " << GREEN << max[j].second 
+                  << RESET << "  num: " << GREEN << max[j].first << endl;
+                if(debug) cout << MAGENTA << "NEW" << RESET << "  index: " << GREEN << index << RESET 
+                  << "  num: " << GREEN << num << RESET << endl;
+                max[j] = make_pair(num, region);
+                break;
+              }
+            }
+          }
+          if(max.size() == num_regions_needed) {
+            for(j=0; j<max.size(); j++) {
+              if(max[j].first != (pow(2, counter_size[p])-1)){
+                if(debug) cout << "reg_bits: " << counter_size[p] << endl;
+                if(debug) cout << "max: " << (pow(2, counter_size[p])-1) << endl;
+                if(debug) cout << MAGENTA << "SMALL" << RESET << "  index: " << GREEN << max[j].second 
+                  << RESET << "  num: " << GREEN << max[j].first << RESET << endl;
+                if(debug) cout << endl;
+                break;  
+              }else if(j == max.size()-1){
+                if(debug) cout << MAGENTA << "BIG" << RESET << "  index: " << GREEN << max[j].second 
+                  << RESET << "  num: " << GREEN << max[j].first << RESET << endl;
+                done = true;
+                if(debug) cout << endl;
+              }
+            }
+          }
+          if(done){
+            break;
+          }
+        }
+        if(debug) {
+          cout << "Size: " << GREEN << max.size() << RESET << endl;
+          cout << "Max: ";
+          for(i=0; i<max.size(); i++) {
+            cout << "(" << GREEN << max[i].first << RESET << "," << MAGENTA << fixed << hex << max[i].second << RESET << ")  ";
+          }
+          cout << endl;
+        }
+
+        //regions this phase kept missing can take the place of the coldest picks
+        if(promote_threshold) {
+          promoted[p] = promote(p, max, num_regions_needed);
+          total_promoted[p] += promoted[p];
+          miss[p].clear();
+        }
+
+        num_regions_per = region_size[p-1]/region_size[p];
+        index = 0;
+
+        //set up mmap
+        for(i=0; i<max.size(); i++) {
+          if(debug) cout << MAGENTA << "START: " << GREEN << fixed << hex << max[i].second << RESET << endl;
+          start_addr = max[i].second;
+          start_addr = start_addr>>mmap_region_zeros[p];
+          if(debug) cout << MAGENTA << "BEGIN: " << GREEN << start_addr << RESET << "  Hex: " 
+            << GREEN << fixed << hex << start_addr << RESET << endl;
+
+          //add sub regions to phase_3_mmap from single region in phase 1
+          for(k=0; k<num_regions_per; k++) {
+            mmap[p].insert(pair<uint64_t, uint64_t>(start_addr, index));
+
+            if(debug) cout << "Phase " << p << " mmap-> " << "Address: " << fixed << hex << start_addr
+              << ", " << dec << start_addr<<mmap_region_zeros[p] << " -- Cache_Index: " << fixed << hex << index
+                << ", " << dec << index << endl;
+
+            index++;
+            start_addr += 1;
+          }
+        }
+      }
+    }
+};
+
+//the counter backend heatmap and libheatmap.a are built on, see counters.h
+#ifndef HEATMAP_COUNTERS
+#define HEATMAP_COUNTERS Uint64Counters
+#endif
+typedef BasicGlobal<HEATMAP_COUNTERS> Global;
+
+#endif
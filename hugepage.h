@@ -0,0 +1,240 @@
+/* File: hugepage.h
+ * Author: Zach McMichael
+ * Description: allocator for the counter tables and region indexes that
+ *				can back them with transparent or explicit huge pages, so
+ *				random increments across a large phase 0 table stop paying
+ *				a TLB miss on almost every access
+ *
+ * Blocks of at least one huge page are mapped on their own, 2MB aligned,
+ * with MAP_HUGETLB when asked for and available, otherwise with
+ * madvise(MADV_HUGEPAGE). Single map nodes come from a free list carved out
+ * of huge page chunks so the rb-tree of an index is packed into a few pages.
+ * Everything else, and everything while huge pages are off, uses malloc.
+ * The mode must be set before the first table is allocated.
+ */
+
+#ifndef HUGEPAGE_H
+#define HUGEPAGE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <new>
+#include <functional>
+#include <utility>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+
+using namespace std;
+
+class HugePages {
+
+  public:
+    enum Mode { OFF, THP, HUGETLB };
+
+    static const size_t PAGE = (size_t)1 << 21; //2MB, the x86-64 and arm64 default
+
+    //shared by every table in the process
+    struct Stats {
+      Mode mode = OFF;
+      uint64_t hugetlb_bytes = 0; //live bytes in explicit huge pages
+      uint64_t thp_bytes = 0; //live bytes advised for transparent huge pages
+      uint64_t fallbacks = 0; //MAP_HUGETLB requests that fell back to madvise
+      uint64_t pool_bytes = 0; //map node chunks, never returned
+    };
+
+    static Stats& stats() {
+      static Stats s;
+      return s;
+    }
+
+    /* parse: read a --hugepages argument
+     * Parameters: string off, thp or hugetlb
+     *             Mode& where to put it
+     * Returns: bool false if it is not one of them
+     */
+    static bool parse(string name, Mode& mode) {
+      if(name == "off") mode = OFF;
+      else if(name == "thp") mode = THP;
+      else if(name == "hugetlb") mode = HUGETLB;
+      else return false;
+      return true;
+    }
+
+    static const char* name(Mode mode) {
+      return mode == HUGETLB ? "hugetlb" : mode == THP ? "thp" : "off";
+    }
+
+    static size_t round_up(size_t bytes) {
+      return (bytes + PAGE-1) & ~(PAGE-1);
+    }
+
+    /* map_block: map a 2MB aligned block in the current mode
+     * Parameters: size_t bytes, a multiple of PAGE
+     * Returns: void* the block, nullptr if nothing could be mapped
+     */
+    static void* map_block(size_t bytes) {
+      Stats& s = stats();
+      void* p;
+      char* raw;
+      char* aligned;
+      size_t lead;
+
+      if(s.mode == HUGETLB) {
+        p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(p != MAP_FAILED) {
+          s.hugetlb_bytes += bytes;
+          return p;
+        }
+        s.fallbacks++;
+      }
+
+      //over map by a page and trim so the block starts on a huge page boundary
+      raw = (char*)::mmap(nullptr, bytes + PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if(raw == MAP_FAILED) return nullptr;
+      aligned = (char*)(((uintptr_t)raw + PAGE-1) & ~(uintptr_t)(PAGE-1));
+      lead = aligned - raw;
+      if(lead) munmap(raw, lead);
+      munmap(aligned + bytes, PAGE - lead);
+#ifdef MADV_HUGEPAGE
+      madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+      s.thp_bytes += bytes;
+      return aligned;
+    }
+
+    /* unmap_block: give back a block from map_block
+     * Parameters: void* the block
+     *             size_t bytes it was mapped with
+     * Returns: None
+     */
+    static void unmap_block(void* p, size_t bytes) {
+      Stats& s = stats();
+      munmap(p, bytes);
+      //the two paths can not be told apart afterwards, so charge hugetlb first
+      if(s.hugetlb_bytes >= bytes) s.hugetlb_bytes -= bytes;
+      else if(s.thp_bytes >= bytes) s.thp_bytes -= bytes;
+    }
+
+    /* anon_huge_bytes: transparent huge pages the kernel actually gave us
+     * Parameters: None
+     * Returns: uint64_t bytes, 0 if /proc does not say
+     */
+    static uint64_t anon_huge_bytes() {
+      ifstream f("/proc/self/smaps_rollup");
+      string key;
+      uint64_t kb;
+
+      while(f >> key) {
+        if(key == "AnonHugePages:" && f >> kb) return kb*1024;
+      }
+      return 0;
+    }
+};
+
+//free list of equally sized map nodes in huge page chunks, one per node size
+template<size_t SIZE>
+class NodePool {
+
+  public:
+    static void* take() {
+      NodePool& p = get();
+      Free* n = p.free;
+
+      if(n) {
+        p.free = n->next;
+        return n;
+      }
+      if(p.left < SIZE) {
+        p.next = (char*)HugePages::map_block(HugePages::PAGE);
+        if(!p.next) throw bad_alloc();
+        p.left = HugePages::PAGE;
+        HugePages::stats().pool_bytes += HugePages::PAGE;
+      }
+      p.left -= SIZE;
+      p.next += SIZE;
+      return p.next - SIZE;
+    }
+
+    static void give(void* node) {
+      NodePool& p = get();
+      Free* n = (Free*)node;
+      n->next = p.free;
+      p.free = n;
+    }
+
+  private:
+    struct Free { Free* next; };
+    Free* free = nullptr;
+    char* next = nullptr;
+    size_t left = 0;
+
+    static NodePool& get() {
+      static NodePool p;
+      return p;
+    }
+};
+
+template<class T>
+class HugePageAllocator {
+
+  public:
+    typedef T value_type;
+
+    HugePageAllocator() {}
+    template<class U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+      size_t bytes = n*sizeof(T);
+      void* p;
+
+      if(HugePages::stats().mode != HugePages::OFF) {
+        if(n == 1) return (T*)NodePool<node_size()>::take();
+        if(bytes >= HugePages::PAGE) {
+          p = HugePages::map_block(HugePages::round_up(bytes));
+          if(!p) throw bad_alloc();
+          return (T*)p;
+        }
+      }
+      p = malloc(bytes ? bytes : 1);
+      if(!p) throw bad_alloc();
+      return (T*)p;
+    }
+
+    void deallocate(T* p, size_t n) {
+      size_t bytes = n*sizeof(T);
+
+      if(HugePages::stats().mode != HugePages::OFF) {
+        if(n == 1) {
+          NodePool<node_size()>::give(p);
+          return;
+        }
+        if(bytes >= HugePages::PAGE) {
+          HugePages::unmap_block(p, HugePages::round_up(bytes));
+          return;
+        }
+      }
+      free(p);
+    }
+
+  private:
+    //nodes are padded to pointer size so the free list fits in them
+    static constexpr size_t node_size() {
+      return sizeof(T) < sizeof(void*) ? sizeof(void*) : (sizeof(T) + sizeof(void*)-1) & ~(sizeof(void*)-1);
+    }
+};
+
+template<class T, class U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return true; }
+template<class T, class U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return false; }
+
+//a phase's counters and its region number to counter index map
+typedef vector<uint64_t, HugePageAllocator<uint64_t>> CounterTable;
+typedef map<uint64_t, uint64_t, less<uint64_t>, HugePageAllocator<pair<const uint64_t, uint64_t>>> RegionIndex;
+
+#endif
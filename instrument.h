@@ -0,0 +1,126 @@
+/* File: instrument.h
+ * Author: Zach McMichael
+ * Description: monotonic clock timers and memory accounting for the
+ *				optional --stats columns
+ */
+
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <map>
+#include <time.h>
+#include <sys/resource.h>
+#include "hugepage.h"
+
+using namespace std;
+
+class Instrument {
+
+  public:
+    int enabled = 0; //only read the clock when --stats is passed
+
+    //per interval
+    uint64_t accesses = 0; //accesses counted this interval
+    uint64_t parse_ns = 0; //time spent reading and tokenizing lines
+    uint64_t count_ns = 0; //time spent in find_offset and change_counter
+    uint64_t rebuild_ns = 0; //time of the heatmap() that started this interval
+    uint64_t interval_start_ns = 0; //wall clock at the start of the interval
+
+    //over the whole run
+    uint64_t total_accesses = 0;
+    uint64_t total_parse_ns = 0;
+    uint64_t total_count_ns = 0;
+    uint64_t run_start_ns = 0;
+    vector<uint64_t> rebuilds; //every heatmap() latency for p50/p99
+
+    /* now_ns: read the monotonic clock
+     * Parameters: None
+     * Returns: uint64_t nanoseconds
+     */
+    static uint64_t now_ns() {
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return (uint64_t)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+    }
+
+    /* start: mark the beginning of the run
+     * Parameters: None
+     * Returns: None
+     */
+    void start() {
+      if(!enabled) return;
+      run_start_ns = now_ns();
+      interval_start_ns = run_start_ns;
+    }
+
+    /* end_interval: fold the interval timers into the run totals and reset them
+     * Parameters: None
+     * Returns: None
+     */
+    void end_interval() {
+      if(!enabled) return;
+      total_accesses += accesses;
+      total_parse_ns += parse_ns;
+      total_count_ns += count_ns;
+      accesses = 0;
+      parse_ns = 0;
+      count_ns = 0;
+      interval_start_ns = now_ns();
+    }
+
+    /* add_rebuild: record the latency of one heatmap() call
+     * Parameters: uint64_t nanoseconds the rebuild took
+     * Returns: None
+     */
+    void add_rebuild(uint64_t ns) {
+      rebuild_ns = ns;
+      rebuilds.push_back(ns);
+    }
+
+    /* accesses_per_sec: throughput of the interval so far
+     * Parameters: None
+     * Returns: double accesses per second of wall time
+     */
+    double accesses_per_sec() {
+      uint64_t elapsed = now_ns() - interval_start_ns;
+      return elapsed ? (double)accesses*1e9/elapsed : 0;
+    }
+
+    /* rebuild_percentile: latency percentile over every rebuild so far
+     * Parameters: double the percentile between 0 and 100
+     * Returns: uint64_t nanoseconds
+     */
+    uint64_t rebuild_percentile(double pct) {
+      if(rebuilds.empty()) return 0;
+      vector<uint64_t> sorted(rebuilds);
+      size_t rank = (size_t)ceil(pct/100*sorted.size());
+      if(rank > 0) rank--;
+      nth_element(sorted.begin(), sorted.begin()+rank, sorted.end());
+      return sorted[rank];
+    }
+
+    /* peak_rss_bytes: high water mark of the resident set
+     * Parameters: None
+     * Returns: uint64_t bytes
+     */
+    static uint64_t peak_rss_bytes() {
+      struct rusage usage;
+      getrusage(RUSAGE_SELF, &usage);
+      return (uint64_t)usage.ru_maxrss*1024; //linux reports kilobytes
+    }
+
+    /* map_bytes: estimated bytes held by an mmap, counting the rb-tree node
+     *            header (three pointers and a color) on top of the pair
+     * Parameters: RegionIndex& the map
+     * Returns: uint64_t bytes
+     */
+    static uint64_t map_bytes(const RegionIndex& m) {
+      return m.size()*(sizeof(pair<const uint64_t, uint64_t>) + 4*sizeof(void*));
+    }
+};
+
+#endif
@@ -0,0 +1,157 @@
+/* File: interval_index.h
+ * Author: Zach McMichael
+ * Description: side index from interval number to the byte offset,
+ *				start timestamp and record count of that interval in a
+ *				dataset, so a window of a large trace can be seeked to
+ *
+ * The file is an IndexHeader followed by count IndexEntry records. It is
+ * only valid for the dataset size, mtime and --interval it was built with.
+ */
+
+#ifndef INTERVAL_INDEX_H
+#define INTERVAL_INDEX_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <sys/stat.h>
+
+using namespace std;
+
+struct IndexEntry {
+  double start_time; //timestamp of the first record
+  uint64_t offset; //byte offset of the first record
+  uint64_t records; //records in the interval
+};
+
+struct IndexHeader {
+  char magic[8]; //"HMIDX1"
+  double interval;
+  uint64_t dataset_size;
+  uint64_t dataset_mtime;
+  uint64_t count;
+};
+
+class IntervalIndex {
+
+  public:
+    vector<IndexEntry> entries;
+    int loaded = 0; //entries came from a valid index file
+
+    /* load: read an index and check it still matches the dataset
+     * Parameters: string the index file
+     *             string the dataset it should describe
+     *             double the interval length
+     * Returns: bool false if it is missing or stale
+     */
+    bool load(string name, string dataset, double interval) {
+      IndexHeader h;
+      FILE* f = fopen(name.c_str(), "rb");
+      bool ok;
+
+      if(!f) return false;
+      ok = fread(&h, sizeof(h), 1, f) == 1
+        && memcmp(h.magic, "HMIDX1", 7) == 0
+        && h.interval == interval
+        && matches(h, dataset);
+      if(ok) {
+        entries.resize(h.count);
+        ok = fread(entries.data(), sizeof(IndexEntry), h.count, f) == h.count;
+      }
+      fclose(f);
+      if(!ok) entries.clear();
+      loaded = ok;
+      return ok;
+    }
+
+    /* save: write the index built during this run
+     * Parameters: string the index file
+     *             string the dataset it describes
+     *             double the interval length
+     * Returns: bool false if it could not be written
+     */
+    bool save(string name, string dataset, double interval) {
+      IndexHeader h;
+      struct stat st;
+      FILE* f;
+      bool ok;
+
+      if(stat(dataset.c_str(), &st) != 0) return false;
+      memset(&h, 0, sizeof(h));
+      memcpy(h.magic, "HMIDX1", 7);
+      h.interval = interval;
+      h.dataset_size = st.st_size;
+      h.dataset_mtime = st.st_mtime;
+      h.count = entries.size();
+      f = fopen(name.c_str(), "wb");
+      if(!f) return false;
+      ok = fwrite(&h, sizeof(h), 1, f) == 1
+        && fwrite(entries.data(), sizeof(IndexEntry), entries.size(), f) == entries.size();
+      return (fclose(f) == 0) && ok;
+    }
+
+    /* scan: build the index with a pass that only parses timestamps, using
+     *       the same boundary rule as the main loop
+     * Parameters: string the dataset
+     *             double the interval length
+     * Returns: bool false if the dataset could not be read
+     */
+    bool scan(string dataset, double interval) {
+      ifstream file(dataset);
+      string line;
+      uint64_t offset;
+      double time;
+      double pause_time = 0;
+
+      if(!file.is_open()) return false;
+      entries.clear();
+      getline(file, line); //remove column names
+      offset = line.size()+1;
+      while(getline(file, line)) {
+        time = strtod(line.c_str(), nullptr);
+        if(entries.empty()) {
+          pause_time = time + interval;
+          begin(time, offset);
+        }else if(pause_time < time) {
+          pause_time = time + interval;
+          begin(time, offset);
+        }
+        entries.back().records++;
+        offset += line.size()+1;
+      }
+      return true;
+    }
+
+    /* begin: start a new interval while building
+     * Parameters: double its first timestamp
+     *             uint64_t byte offset of its first record
+     * Returns: None
+     */
+    void begin(double time, uint64_t offset) {
+      entries.push_back({time, offset, 0});
+    }
+
+    /* find_time: the interval a timestamp falls in
+     * Parameters: double the timestamp
+     * Returns: uint64_t the interval number, 0 if before the first
+     */
+    uint64_t find_time(double time) {
+      auto it = upper_bound(entries.begin(), entries.end(), time,
+        [](double t, const IndexEntry& e) { return t < e.start_time; });
+      return it == entries.begin() ? 0 : (it - entries.begin()) - 1;
+    }
+
+  private:
+    static bool matches(const IndexHeader& h, string dataset) {
+      struct stat st;
+      if(stat(dataset.c_str(), &st) != 0) return false;
+      return h.dataset_size == (uint64_t)st.st_size && h.dataset_mtime == (uint64_t)st.st_mtime;
+    }
+};
+
+#endif
@@ -0,0 +1,170 @@
+/* File: interval_policy.h
+ * Author: Zach McMichael
+ * Description: decides where one interval ends and the next begins, by
+ *				time, by access count, on counter saturation, or with a
+ *				controller that resizes the time interval as it goes
+ */
+
+#ifndef INTERVAL_POLICY_H
+#define INTERVAL_POLICY_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include "heatmap.h"
+
+using namespace std;
+
+class IntervalPolicy {
+
+  public:
+    enum Kind { TIME, COUNT, SATURATE, ADAPTIVE };
+
+    Kind kind = TIME;
+    double length; //current time interval in seconds
+    double base_length; //the --interval it started from
+    uint64_t count = 0; //accesses per interval for COUNT
+    double saturation = 50; //percent of counters at their maximum that ends a SATURATE interval
+    double overhead = 5; //percent of rebuild time ADAPTIVE tries to stay under
+    uint64_t min_accesses = 1024; //SATURATE waits for this many before checking
+
+    //the interval that just ended
+    const char* ended_by = "time"; //what closed it
+    uint64_t accesses = 0; //accesses it held
+    double start_time = 0; //its first timestamp
+    double duration = 0; //seconds between its first and last timestamp
+    double saturated = 0; //percent of counters at their maximum in the finest active phase
+
+    /* parse: read a --policy argument
+     * Parameters: string time, count:N, saturate:PCT or adaptive[:PCT[:OVERHEAD]]
+     * Returns: bool false if it is not understood
+     */
+    bool parse(string arg) {
+      string name = arg.substr(0, arg.find(':'));
+      string rest = arg.size() > name.size() ? arg.substr(name.size()+1) : "";
+
+      if(name == "time") {
+        kind = TIME;
+      }else if(name == "count") {
+        kind = COUNT;
+        count = strtoull(rest.c_str(), nullptr, 10);
+        if(count == 0) return false;
+      }else if(name == "saturate") {
+        kind = SATURATE;
+        if(!rest.empty()) saturation = atof(rest.c_str());
+      }else if(name == "adaptive") {
+        kind = ADAPTIVE;
+        if(!rest.empty() && sscanf(rest.c_str(), "%lf:%lf", &saturation, &overhead) < 1) return false;
+      }else{
+        return false;
+      }
+      return true;
+    }
+
+    const char* name() {
+      switch(kind) {
+        case COUNT: return "count";
+        case SATURATE: return "saturate";
+        case ADAPTIVE: return "adaptive";
+        default: return "time";
+      }
+    }
+
+    /* setup: start from the --interval length
+     * Parameters: float the --interval length
+     * Returns: None
+     */
+    void setup(float interval) {
+      base_length = interval;
+      length = interval;
+    }
+
+    /* start: begin the first interval
+     * Parameters: double the first timestamp
+     * Returns: double the timestamp that ends it
+     */
+    double start(double time) {
+      start_time = time;
+      last_time = time;
+      running = 1;
+      return time + length;
+    }
+
+    /* boundary: does this access start a new interval, checked before it
+     *           is counted
+     * Parameters: double its timestamp
+     *             double the timestamp that ends the current interval
+     *             Global& the tracker
+     * Returns: bool true if the current interval is over
+     */
+    bool boundary(double time, double pause_time, Global& G) {
+      int p;
+
+      switch(kind) {
+        case COUNT:
+          if(running < count) break;
+          ended_by = "count";
+          return true;
+        case SATURATE:
+          if(pause_time < time) {
+            ended_by = "time";
+            return true;
+          }
+          //the tracker keeps its full counters up to date, so this is checked every access
+          p = G.active_phases-1;
+          if(running < min_accesses || full_percent(G, p) < saturation) break;
+          ended_by = "sat";
+          return true;
+        default:
+          if(!(pause_time < time)) break;
+          ended_by = kind == ADAPTIVE ? "adapt" : "time";
+          return true;
+      }
+      last_time = time;
+      running++;
+      return false;
+    }
+
+    /* next: close the interval that just ended and open the next
+     * Parameters: double the timestamp of the first access of the next
+     *             Global& the tracker, before its counters are cleared
+     *             uint64_t ns the rebuild at the previous boundary took
+     *             uint64_t ns the interval took to count, wall clock
+     * Returns: double the timestamp that ends the next interval
+     */
+    double next(double time, Global& G, uint64_t rebuild_ns, uint64_t interval_ns) {
+      accesses = running;
+      duration = last_time - start_time;
+      saturated = full_percent(G, G.active_phases-1);
+      if(kind == ADAPTIVE) adapt(rebuild_ns, interval_ns);
+      start_time = time;
+      last_time = time;
+      running = 1;
+      return time + length;
+    }
+
+  private:
+    double last_time = 0; //timestamp of the last access counted
+    uint64_t running = 0; //accesses so far in the current interval
+
+    //percent of the counters phase p uses that are at their maximum
+    static double full_percent(Global& G, int p) {
+      pair<uint64_t, uint64_t> full = G.full_counters(p);
+      return full.second ? 100.0*full.first/full.second : 0;
+    }
+
+    //halve when counters saturate, double when rebuilds dominate, and
+    //creep back up while things are quiet, within 1/64x to 64x of the start
+    void adapt(uint64_t rebuild_ns, uint64_t interval_ns) {
+      double cost = interval_ns ? 100.0*rebuild_ns/interval_ns : 0;
+
+      if(saturated > saturation) length *= 0.5;
+      else if(cost > overhead) length *= 2;
+      else if(saturated < saturation/4) length *= 1.25;
+      length = min(max(length, base_length/64), base_length*64);
+    }
+};
+
+#endif
@@ -0,0 +1,99 @@
+/* File: miss_filter.h
+ * Author: Zach McMichael
+ * Description: fixed size record of the regions a phase keeps missing, a
+ *				counting bloom filter in front of a short candidate list,
+ *				so heatmap() can promote a new hot spot straight into the
+ *				phase instead of waiting for it to cascade down
+ */
+
+#ifndef MISS_FILTER_H
+#define MISS_FILTER_H
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+class MissFilter {
+
+  public:
+    static const int COUNTER_BITS = 12; //log2 of the counters in the filter
+    static const int HASHES = 3;
+    static const int CANDIDATES = 16;
+    static const uint64_t MAX_THRESHOLD = UINT16_MAX; //the filter counters saturate here
+
+    int shift = 0; //log2 of the region size a candidate covers
+    uint64_t threshold = 0; //misses before a region becomes a candidate
+    vector<pair<uint64_t, uint64_t>> candidates; //(region number, estimated misses)
+
+    /* setup: size the filter, all state is fixed size after this
+     * Parameters: int log2 of the candidate region size
+     *             uint64_t misses before a region becomes a candidate
+     * Returns: None
+     */
+    void setup(int region_bits, uint64_t min_misses) {
+      shift = region_bits;
+      threshold = min_misses;
+      counts.assign((size_t)1 << COUNTER_BITS, 0);
+      candidates.clear();
+      candidates.reserve(CANDIDATES);
+    }
+
+    /* miss: note accesses the phase did not track, counters only grow
+     *       where they are the smallest of the region's counters
+     * Parameters: uint64_t the address that missed
+     *             uint64_t how many accesses, 1 unless they were coalesced
+     * Returns: None
+     */
+    void miss(uint64_t addr, uint64_t n = 1) {
+      uint64_t key = addr >> shift;
+      uint64_t slot[HASHES];
+      uint16_t low = UINT16_MAX;
+      size_t i, weakest = 0;
+      int h;
+
+      for(h=0; h<HASHES; h++) {
+        slot[h] = (key*SEEDS[h]) >> (64-COUNTER_BITS);
+        low = min(low, counts[slot[h]]);
+      }
+      //a saturated region has passed any threshold, it still has to reach the candidates
+      if(low < UINT16_MAX) {
+        low = (n < (uint64_t)(UINT16_MAX - low)) ? low + n : UINT16_MAX;
+        for(h=0; h<HASHES; h++) {
+          if(counts[slot[h]] < low) counts[slot[h]] = low;
+        }
+      }
+      if(low < threshold) return;
+
+      //keep the candidates with the most misses
+      for(i=0; i<candidates.size(); i++) {
+        if(candidates[i].first == key) {
+          candidates[i].second = low;
+          return;
+        }
+        if(candidates[i].second < candidates[weakest].second) weakest = i;
+      }
+      if(candidates.size() < CANDIDATES) {
+        candidates.push_back(make_pair(key, low));
+      }else if(candidates[weakest].second < low) {
+        candidates[weakest] = make_pair(key, low);
+      }
+    }
+
+    /* clear: forget the interval's misses
+     * Parameters: None
+     * Returns: None
+     */
+    void clear() {
+      fill(counts.begin(), counts.end(), 0);
+      candidates.clear();
+    }
+
+  private:
+    static constexpr uint64_t SEEDS[HASHES] = {0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL};
+    vector<uint16_t> counts;
+};
+
+#endif
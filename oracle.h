@@ -0,0 +1,192 @@
+/* File: oracle.h
+ * Author: Zach McMichael
+ * Description: exact per interval access histograms at the finest phase
+ *				granularity, used to score the hot regions heatmap() picks
+ */
+
+#ifndef ORACLE_H
+#define ORACLE_H
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <utility>
+#include "hugepage.h"
+
+using namespace std;
+
+class Oracle {
+
+  public:
+    static const int DIGIT_BITS = 16; //radix sort digit
+
+    int enabled = 0; //only buffer addresses when --oracle is passed
+    int shift; //log2 of the finest region size
+    int key_bits; //number of bits left in a region number
+    vector<uint64_t> keys; //region number of every access this interval
+    vector<uint64_t> scratch; //second buffer for the radix sort
+    vector<pair<uint64_t, uint64_t>> histogram; //(region, exact count) sorted by region
+
+    //results of the last scored interval
+    int scored; //0 when the finest phase was not active yet
+    double precision; //tracked regions that are in the true hot set
+    double recall; //true hot regions that were tracked
+    double coverage; //accesses that landed in tracked regions
+    double best_coverage; //accesses the true hot set of the same size would cover
+    uint64_t exact_bytes; //key buffers, radix counts, histogram and top list the interval needed
+
+    //over the whole run
+    uint64_t intervals_scored = 0;
+    double sum_precision = 0;
+    double sum_recall = 0;
+    double sum_coverage = 0;
+    double sum_best_coverage = 0;
+    uint64_t peak_exact_bytes = 0;
+
+    /* setup: size the oracle for the finest phase
+     * Parameters: int log2 of the finest region size
+     *             int bits needed to address the whole space
+     * Returns: None
+     */
+    void setup(int region_bits, int addressable_bits) {
+      shift = region_bits;
+      key_bits = addressable_bits > region_bits ? addressable_bits-region_bits : 1;
+    }
+
+    /* add: buffer one access
+     * Parameters: uint64_t the address that was accessed
+     * Returns: None
+     */
+    void add(uint64_t addr) {
+      keys.push_back(addr >> shift);
+    }
+
+    /* radix_sort: lsd radix sort of the buffered keys in 16 bit digits,
+     *             skipping any digit every key agrees on
+     * Parameters: None
+     * Returns: None
+     */
+    void radix_sort() {
+      const size_t buckets = 1 << DIGIT_BITS;
+      vector<size_t> count(buckets);
+      size_t n = keys.size();
+      size_t i, sum, tmp;
+      int pass;
+
+      scratch.resize(n);
+      for(pass=0; pass*DIGIT_BITS < key_bits; pass++) {
+        int s = pass*DIGIT_BITS;
+        fill(count.begin(), count.end(), 0);
+        for(i=0; i<n; i++) count[(keys[i] >> s) & (buckets-1)]++;
+        if(count[(keys[0] >> s) & (buckets-1)] == n) continue;
+        sum = 0;
+        for(i=0; i<buckets; i++) {
+          tmp = count[i];
+          count[i] = sum;
+          sum += tmp;
+        }
+        for(i=0; i<n; i++) scratch[count[(keys[i] >> s) & (buckets-1)]++] = keys[i];
+        keys.swap(scratch);
+      }
+    }
+
+    /* build_histogram: sort the interval and count runs of equal regions
+     * Parameters: None
+     * Returns: None
+     */
+    void build_histogram() {
+      size_t i, run;
+
+      histogram.clear();
+      if(keys.empty()) return;
+      radix_sort();
+      run = 0;
+      for(i=1; i<=keys.size(); i++) {
+        if(i == keys.size() || keys[i] != keys[run]) {
+          histogram.push_back(make_pair(keys[run], (uint64_t)(i-run)));
+          run = i;
+        }
+      }
+    }
+
+    /* score: compare the regions the finest phase tracked this interval
+     *        against the exact top regions of the same count
+     *        against the exact top regions of the same count, regions a
+     *        predictor seeded past the phase's own slots are left out
+     * Parameters: RegionIndex& the finest phase mmap, keyed by region number
+     *             uint64_t the phase's own slots, higher indexes were seeded
+     *             int 1 if the finest phase was active this interval
+     * Returns: None
+     */
+    void score(const RegionIndex& tracked, uint64_t own, int active) {
+      vector<pair<uint64_t, uint64_t>> top;
+      uint64_t total = keys.size();
+      uint64_t covered = 0;
+      uint64_t best = 0;
+      uint64_t common = 0;
+      uint64_t held = 0; //tracked regions in the phase's own slots
+      size_t k, i;
+
+      build_histogram();
+      //everything the exact answer holds at once, top is at most a copy of the histogram
+      exact_bytes = (keys.capacity() + scratch.capacity())*sizeof(uint64_t)
+        + ((size_t)1 << DIGIT_BITS)*sizeof(size_t)
+        + (histogram.capacity() + histogram.size())*sizeof(pair<uint64_t, uint64_t>);
+      if(exact_bytes > peak_exact_bytes) peak_exact_bytes = exact_bytes;
+      for(auto& m : tracked) if(m.second < own) held++;
+      scored = active && total > 0 && held > 0;
+      keys.clear();
+      if(!scored) return;
+
+      //true hot set is the k hottest regions, k being what the tracker could hold
+      k = min((size_t)held, histogram.size());
+      top = histogram;
+      nth_element(top.begin(), top.begin()+(k-1), top.end(),
+        [](const pair<uint64_t, uint64_t>& a, const pair<uint64_t, uint64_t>& b) {
+          return a.second > b.second;
+        });
+      top.resize(k);
+      for(i=0; i<k; i++) best += top[i].second;
+      sort(top.begin(), top.end());
+
+      //both lists are sorted by region so one merge gives the overlap and coverage
+      auto t = tracked.begin();
+      for(i=0; t != tracked.end() && i < histogram.size(); ) {
+        if(t->second >= own || t->first < histogram[i].first) {
+          t++;
+        }else if(histogram[i].first < t->first) {
+          i++;
+        }else{
+          covered += histogram[i].second;
+          t++;
+          i++;
+        }
+      }
+      auto u = tracked.begin();
+      for(i=0; u != tracked.end() && i < top.size(); ) {
+        if(u->second >= own || u->first < top[i].first) {
+          u++;
+        }else if(top[i].first < u->first) {
+          i++;
+        }else{
+          common++;
+          u++;
+          i++;
+        }
+      }
+
+      precision = (double)common/held;
+      recall = (double)common/k;
+      coverage = (double)covered/total*100;
+      best_coverage = (double)best/total*100;
+
+      intervals_scored++;
+      sum_precision += precision;
+      sum_recall += recall;
+      sum_coverage += coverage;
+      sum_best_coverage += best_coverage;
+    }
+};
+
+#endif
@@ -0,0 +1,191 @@
+/* File: parallel.h
+ * Author: Zach McMichael
+ * Description: offline two pass reader, worker threads parse whole
+ *				intervals of the dataset and build their phase 0
+ *				histograms while the main loop refines phases 1 and 2
+ *
+ * Phase 0 is cleared every interval so its counts only depend on the
+ * interval's own accesses. The interval index gives each interval's byte
+ * offset and record count, so batches of intervals are parsed in parallel
+ * one batch ahead of the main loop, which reads the parsed records back
+ * in order and installs each interval's phase 0 counts at its boundary.
+ * Histograms live outside the batches since an interval's boundary is
+ * only seen once the next batch is already being read. A worker sorts the
+ * interval's region numbers in a buffer it keeps between batches, so its
+ * memory follows the records parsed, never the size of phase 0.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include "heatmap.h"
+#include "interval_index.h"
+
+using namespace std;
+
+class ParallelReader {
+
+  public:
+    int threads = 1;
+    uint64_t batch_intervals; //intervals parsed per batch
+
+    /* open: start parsing the first batch
+     * Parameters: string the dataset
+     *             IntervalIndex& boundaries of every interval
+     *             Global& the tracker, after setup()
+     *             int worker threads
+     * Returns: None
+     */
+    void open(string dataset, IntervalIndex& index, Global& G, int workers) {
+      name = dataset;
+      entries = &index.entries;
+      shift = G.region_shift_0;
+      regions = G.num_cache_regions[0];
+      threads = workers > 0 ? workers : 1;
+      batch_intervals = threads*2;
+      next_first = 0;
+      pos = 0;
+      histograms.assign(entries->size(), vector<pair<uint64_t, uint64_t>>());
+      keys.assign(threads, vector<uint64_t>());
+      launch();
+      swap_in();
+    }
+
+    /* next: the next parsed record in dataset order
+     * Parameters: double& the timestamp
+     *             uint64_t& the address
+     * Returns: bool false at the end of the dataset
+     */
+    bool next(double& time, uint64_t& addr) {
+      while(pos == current.records.size()) {
+        if(current.first + current.count >= entries->size()) return false;
+        swap_in();
+      }
+      time = current.records[pos].first;
+      addr = current.records[pos].second;
+      pos++;
+      return true;
+    }
+
+    /* install: put an interval's phase 0 counts into the tracker, as if
+     *          every access had gone through change_counter
+     * Parameters: Global& the tracker
+     *             uint64_t the interval, counted from the start of the dataset
+     * Returns: None
+     */
+    void install(Global& G, uint64_t interval) {
+      uint64_t inc = 0, total = 0, value;
+
+      if(interval >= histograms.size()) return;
+      for(auto& h : histograms[interval]) {
+        value = min(h.second, G.counter_max[0]);
+        G.set_counter(0, h.first, value);
+        inc += value;
+        total += h.second;
+      }
+      G.cache_hits[0] = total;
+      G.cache_misses[0] = 0;
+      G.counter_inc[0] = inc;
+      G.counter_dec[0] = total - inc;
+      vector<pair<uint64_t, uint64_t>>().swap(histograms[interval]);
+    }
+
+    ~ParallelReader() {
+      for(auto& t : pool) t.join();
+    }
+
+  private:
+    struct Batch {
+      uint64_t first = 0; //first interval in the batch
+      uint64_t count = 0;
+      vector<pair<double, uint64_t>> records; //every record of the batch in order
+    };
+
+    string name;
+    vector<IndexEntry>* entries;
+    int shift;
+    uint64_t regions;
+    uint64_t next_first; //first interval of the batch being parsed
+    Batch current; //being read by the main loop
+    Batch ahead; //being parsed by the workers
+    vector<vector<pair<uint64_t, uint64_t>>> histograms; //(region, raw count) per interval, freed once installed
+    vector<vector<uint64_t>> keys; //per worker, region numbers of the interval being parsed
+    vector<thread> pool;
+    size_t pos; //next record in current
+
+    //start the workers on the next batch of intervals
+    void launch() {
+      uint64_t first = next_first;
+      uint64_t count = min(batch_intervals, (uint64_t)entries->size() - first);
+      uint64_t i, at = 0;
+      vector<uint64_t> start(count);
+      int t;
+
+      ahead.first = first;
+      ahead.count = count;
+      for(i=0; i<count; i++) {
+        start[i] = at;
+        at += (*entries)[first+i].records;
+      }
+      ahead.records.resize(at);
+      next_first = first + count;
+
+      //interval i goes to worker i % threads
+      for(t=0; t<threads && t<(int)count; t++) {
+        pool.emplace_back([this, t, count, start]() {
+          for(uint64_t k=t; k<count; k+=threads) parse_interval(k, start[k], keys[t]);
+        });
+      }
+    }
+
+    //wait for the workers and make their batch the current one
+    void swap_in() {
+      for(auto& t : pool) t.join();
+      pool.clear();
+      swap(current, ahead);
+      pos = 0;
+      if(next_first < entries->size()) launch();
+    }
+
+    //parse one interval into its slice of the batch and count its phase 0 regions
+    void parse_interval(uint64_t k, uint64_t at, vector<uint64_t>& touched) {
+      const IndexEntry& e = (*entries)[ahead.first + k];
+      FILE* f = fopen(name.c_str(), "r");
+      char* line = nullptr; //getline grows it, so long lines are never split
+      size_t size = 0;
+      char* comma;
+      uint64_t i, region;
+      size_t j, run;
+
+      if(!f) return;
+      touched.clear();
+      fseeko(f, e.offset, SEEK_SET);
+      for(i=0; i<e.records && getline(&line, &size, f) != -1; i++) {
+        auto& r = ahead.records[at+i];
+        r.first = strtod(line, &comma);
+        r.second = (*comma == ',') ? strtoull(comma+1, nullptr, 16) : 0;
+        region = r.second >> shift;
+        if(region < regions) touched.push_back(region);
+      }
+      free(line);
+      fclose(f);
+
+      //equal regions are next to each other once sorted, count the runs
+      sort(touched.begin(), touched.end());
+      auto& h = histograms[ahead.first + k];
+      for(j=0; j<touched.size(); j+=run) {
+        for(run=1; j+run<touched.size() && touched[j+run] == touched[j]; run++);
+        h.push_back(make_pair(touched[j], run));
+      }
+    }
+};
+
+#endif
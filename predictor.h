@@ -0,0 +1,235 @@
+/* File: predictor.h
+ * Author: Zach McMichael
+ * Description: guesses which regions of the phase above will be hot next
+ *				interval from the regions heatmap() picked so far, and seeds
+ *				them into phases 1 and 2 past the phase's own slots
+ *
+ * The models work on picks, regions of the phase above as heatmap() picks
+ * them, and each seeded pick brings all of its sub regions:
+ *   last    the hottest regions the phase tracked last interval that were
+ *           not picked again, ranked by the count they reached
+ *   stride  the most common shift between the last two sets of picks, when
+ *           at least a quarter of the picks moved by it, applied once more
+ *   markov  pairs the picks that left with the picks that came in, by
+ *           address order, and seeds what followed a current pick before
+ * A seeded region that was tracked last interval keeps half of its count.
+ * Seeds only catch accesses the phase would have missed, so their hits are
+ * exactly what the prediction added to the hit rate.
+ */
+
+#ifndef PREDICTOR_H
+#define PREDICTOR_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <algorithm>
+#include "heatmap.h"
+
+using namespace std;
+
+class Predictor {
+
+  public:
+    enum Model { LAST, STRIDE, MARKOV };
+    static const uint64_t MARKOV_LIMIT = 1 << 16; //picks remembered per phase
+
+    int enabled = 0; //only seed when --predict is passed
+    Model model = LAST;
+    uint64_t picks = 0; //picks seeded per phase, 0 for a quarter of the phase
+
+    //per phase over the whole run
+    uint64_t budget[3] = {0, 0, 0}; //picks that may be seeded each rebuild
+    uint64_t rebuilds[3] = {0, 0, 0};
+    uint64_t total_seeded[3] = {0, 0, 0}; //regions seeded
+    uint64_t total_seeded_hits[3] = {0, 0, 0};
+
+    /* parse: read a --predict argument
+     * Parameters: string last, stride or markov, with an optional :PICKS
+     * Returns: bool false if it is not understood
+     */
+    bool parse(string arg) {
+      string name = arg.substr(0, arg.find(':'));
+
+      if(name == "last") model = LAST;
+      else if(name == "stride") model = STRIDE;
+      else if(name == "markov") model = MARKOV;
+      else return false;
+      if(arg.size() > name.size()) {
+        picks = strtoull(arg.c_str() + name.size() + 1, nullptr, 10);
+        if(picks == 0) return false;
+      }
+      enabled = 1;
+      return true;
+    }
+
+    const char* name() const {
+      return model == LAST ? "last" : model == STRIDE ? "stride" : "markov";
+    }
+
+    /* setup: reserve the seed slots in the tracker
+     * Parameters: Global& the tracker, after setup()
+     * Returns: None
+     */
+    void setup(Global& G) {
+      for(int p=1; p<3; p++) {
+        sub_bits[p] = ((p == 1) ? G.region_shift_0 : G.mmap_region_zeros[1]) - G.mmap_region_zeros[p];
+        budget[p] = picks ? picks : max((uint64_t)1, G.total_data_size[p]/G.region_size[p-1]/4);
+        G.extra_regions[p] = budget[p] << sub_bits[p];
+      }
+    }
+
+    /* observe: keep what the phases counted that seed() may use, before
+     *          heatmap() clears them. last ranks by every count, the other
+     *          models only carry half a count, so counts under 2 carry nothing
+     *          and nothing is kept before they have picks to work from
+     * Parameters: Global& the tracker
+     * Returns: None
+     */
+    void observe(Global& G) {
+      for(int p=1; p<G.active_phases; p++) {
+        uint64_t least = (model == LAST) ? 1 : 2;
+        counts[p].clear();
+        if(model != LAST && previous[p].empty()) continue;
+        for(auto& m : G.mmap[p]) {
+          uint64_t c = G.heat(p, m.second);
+          if(c >= least) counts[p].push_back(make_pair(m.first, c));
+        }
+      }
+    }
+
+    /* seed: predict from the picks heatmap() just made and seed the guesses
+     * Parameters: Global& the tracker, right after heatmap()
+     * Returns: None
+     */
+    void seed(Global& G) {
+      for(int p=1; p<G.active_phases; p++) {
+        current.clear();
+        for(auto& m : G.mmap[p]) {
+          uint64_t pick = m.first >> sub_bits[p];
+          if(current.empty() || current.back() != pick) current.push_back(pick);
+        }
+
+        guesses.clear();
+        if(model == LAST) guess_last(p);
+        else if(model == STRIDE) guess_stride(p);
+        else guess_markov(p);
+        place(G, p);
+
+        previous[p].swap(current);
+        rebuilds[p]++;
+      }
+    }
+
+  private:
+    int sub_bits[3] = {0, 0, 0}; //log2 of the sub regions per pick
+    vector<pair<uint64_t, uint64_t>> counts[3]; //(region number, count) tracked last interval, sorted
+    vector<uint64_t> previous[3]; //picks of the rebuild before, sorted
+    vector<uint64_t> current; //picks of this rebuild, sorted
+    vector<pair<uint64_t, uint64_t>> guesses; //(weight, pick)
+    unordered_map<uint64_t, uint64_t> tally;
+
+    //up to two picks seen coming in when a pick left, with how often
+    struct Successors {
+      uint64_t pick[2];
+      uint64_t seen[2];
+    };
+    unordered_map<uint64_t, Successors> markov[3];
+
+    bool picked(uint64_t pick) const {
+      return binary_search(current.begin(), current.end(), pick);
+    }
+
+    //the hottest picks the phase tracked last interval
+    void guess_last(int p) {
+      tally.clear();
+      for(auto& c : counts[p]) tally[c.first >> sub_bits[p]] += c.second;
+      for(auto& t : tally) {
+        if(!picked(t.first)) guesses.push_back(make_pair(t.second, t.first));
+      }
+    }
+
+    //the shift most picks moved by, applied again
+    void guess_stride(int p) {
+      uint64_t best = 0, support = 0; //shifts wrap, so a negative one is a large best
+
+      if(previous[p].empty() || current.empty()) return;
+      tally.clear();
+      for(auto pick : current) {
+        auto next = lower_bound(previous[p].begin(), previous[p].end(), pick);
+        uint64_t nearest;
+        if(next == previous[p].end()) nearest = previous[p].back();
+        else if(next == previous[p].begin() || *next - pick < pick - *(next-1)) nearest = *next;
+        else nearest = *(next-1);
+        if(nearest != pick) tally[pick - nearest]++;
+      }
+      for(auto& t : tally) {
+        if(t.second > support || (t.second == support && t.first < best)) {
+          best = t.first;
+          support = t.second;
+        }
+      }
+      if(support*4 < current.size()) return;
+      for(auto pick : current) {
+        uint64_t next = pick + best;
+        if(!picked(next)) guesses.push_back(make_pair(support, next));
+      }
+    }
+
+    //learn which picks came in as others left, then follow the current picks
+    void guess_markov(int p) {
+      vector<uint64_t> left, entered;
+      size_t i;
+      int s;
+
+      set_difference(previous[p].begin(), previous[p].end(), current.begin(), current.end(), back_inserter(left));
+      set_difference(current.begin(), current.end(), previous[p].begin(), previous[p].end(), back_inserter(entered));
+      for(i=0; i<left.size() && i<entered.size(); i++) {
+        auto found = markov[p].find(left[i]);
+        if(found == markov[p].end()) {
+          if(markov[p].size() >= MARKOV_LIMIT) continue;
+          markov[p][left[i]] = {{entered[i], 0}, {1, 0}};
+          continue;
+        }
+        Successors& next = found->second;
+        if(next.pick[0] == entered[i] && next.seen[0]) next.seen[0]++;
+        else if(next.pick[1] == entered[i] && next.seen[1]) next.seen[1]++;
+        else if(next.seen[1] < next.seen[0]) next = {{next.pick[0], entered[i]}, {next.seen[0], 1}};
+        else next = {{entered[i], next.pick[1]}, {1, next.seen[1]}};
+      }
+
+      tally.clear();
+      for(auto pick : current) {
+        auto found = markov[p].find(pick);
+        if(found == markov[p].end()) continue;
+        for(s=0; s<2; s++) {
+          uint64_t next = found->second.pick[s];
+          if(found->second.seen[s] && !picked(next)) tally[next] += found->second.seen[s];
+        }
+      }
+      for(auto& t : tally) guesses.push_back(make_pair(t.second, t.first));
+    }
+
+    //seed the heaviest guesses, carrying half of any count they had
+    void place(Global& G, int p) {
+      uint64_t k, region, carried;
+      size_t n = min((size_t)budget[p], guesses.size());
+
+      partial_sort(guesses.begin(), guesses.begin()+n, guesses.end(),
+        [](const pair<uint64_t, uint64_t>& a, const pair<uint64_t, uint64_t>& b) {
+          return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+      for(size_t g=0; g<n; g++) {
+        for(k=0; k<(1ULL << sub_bits[p]); k++) {
+          region = (guesses[g].second << sub_bits[p]) + k;
+          auto found = lower_bound(counts[p].begin(), counts[p].end(), make_pair(region, (uint64_t)0));
+          carried = (found != counts[p].end() && found->first == region) ? found->second/2 : 0;
+          if(G.seed(p, region, carried)) total_seeded[p]++;
+        }
+      }
+    }
+};
+
+#endif
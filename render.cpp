@@ -0,0 +1,301 @@
+/* File: render.cpp
+ * Author: Zach McMichael
+ * Description: renders a time x address heat image from a file written
+ *				by heatmap --export, building image bands in parallel
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <math.h>
+#include <getopt.h>
+#include "export.h"
+
+#define RESET   "\033[0m"
+#define RED     "\033[31m"
+#define GREEN   "\033[32m"
+
+using namespace std;
+
+struct Row {
+  vector<pair<uint64_t, uint64_t>> entries; //(region number, count) of one interval
+};
+
+/* heat_color: map a value in [0, 1] onto black, red, yellow, white
+ * Parameters: double the scaled value
+ *             unsigned char* where to put r, g, b
+ * Returns: None
+ */
+void heat_color(double v, unsigned char* rgb) {
+  double r = min(1.0, v*3);
+  double g = min(1.0, max(0.0, v*3-1));
+  double b = min(1.0, max(0.0, v*3-2));
+  rgb[0] = (unsigned char)(r*255);
+  rgb[1] = (unsigned char)(g*255);
+  rgb[2] = (unsigned char)(b*255);
+}
+
+/* crc32: png chunk checksum
+ * Parameters: the bytes, length and the running crc
+ * Returns: uint32_t the updated crc
+ */
+uint32_t crc32(const unsigned char* buf, size_t len, uint32_t crc) {
+  static uint32_t table[256];
+  static bool built = false;
+  uint32_t c;
+  size_t i;
+  int k;
+
+  if(!built) {
+    for(i=0; i<256; i++) {
+      c = (uint32_t)i;
+      for(k=0; k<8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    built = true;
+  }
+  crc = ~crc;
+  for(i=0; i<len; i++) crc = table[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+void put_be32(vector<unsigned char>& out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+/* write_chunk: append a png chunk with its length and crc
+ * Parameters: FILE* the output
+ *             const char* the four letter chunk type
+ *             vector<unsigned char>& the chunk data
+ * Returns: None
+ */
+void write_chunk(FILE* f, const char* type, const vector<unsigned char>& data) {
+  vector<unsigned char> head;
+  vector<unsigned char> tail;
+  uint32_t crc;
+
+  put_be32(head, data.size());
+  head.insert(head.end(), type, type+4);
+  crc = crc32((const unsigned char*)type, 4, 0);
+  crc = crc32(data.data(), data.size(), crc);
+  put_be32(tail, crc);
+  fwrite(head.data(), 1, head.size(), f);
+  fwrite(data.data(), 1, data.size(), f);
+  fwrite(tail.data(), 1, tail.size(), f);
+}
+
+/* write_png: write an rgb image as a png using stored (uncompressed)
+ *            deflate blocks so no zlib is needed
+ * Parameters: FILE* the output
+ *             vector<unsigned char>& rgb pixels, row major
+ *             uint64_t width, height
+ * Returns: None
+ */
+void write_png(FILE* f, const vector<unsigned char>& rgb, uint64_t width, uint64_t height) {
+  const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  vector<unsigned char> ihdr;
+  vector<unsigned char> raw;
+  vector<unsigned char> idat;
+  uint32_t a = 1, b = 0; //adler32
+  size_t y, pos, len;
+
+  fwrite(signature, 1, 8, f);
+  put_be32(ihdr, width);
+  put_be32(ihdr, height);
+  ihdr.push_back(8); //bit depth
+  ihdr.push_back(2); //truecolor
+  ihdr.push_back(0);
+  ihdr.push_back(0);
+  ihdr.push_back(0);
+  write_chunk(f, "IHDR", ihdr);
+
+  //every scanline starts with filter type 0
+  raw.reserve(height*(width*3+1));
+  for(y=0; y<height; y++) {
+    raw.push_back(0);
+    raw.insert(raw.end(), rgb.begin()+y*width*3, rgb.begin()+(y+1)*width*3);
+  }
+
+  idat.push_back(0x78);
+  idat.push_back(0x01);
+  for(pos=0; pos<raw.size(); pos+=len) {
+    len = min((size_t)65535, raw.size()-pos);
+    idat.push_back(pos+len >= raw.size() ? 1 : 0);
+    idat.push_back(len & 0xff);
+    idat.push_back(len >> 8);
+    idat.push_back(~len & 0xff);
+    idat.push_back((~len >> 8) & 0xff);
+    idat.insert(idat.end(), raw.begin()+pos, raw.begin()+pos+len);
+  }
+  for(unsigned char c : raw) {
+    a = (a + c) % 65521;
+    b = (b + a) % 65521;
+  }
+  put_be32(idat, (b << 16) | a);
+  write_chunk(f, "IDAT", idat);
+  write_chunk(f, "IEND", vector<unsigned char>());
+}
+
+int main(int argc, char* argv[]) {
+  int opt;
+  int opt_index = 0;
+  string input = "";
+  string output = "heatmap.png";
+  int phase = 0;
+  int run = -1; //last run in the file
+  uint64_t width = 1024;
+  uint64_t height = 0; //one row per interval, capped at 4096
+  unsigned threads = thread::hardware_concurrency();
+
+  static struct option long_options[] = {
+    {  "input",  required_argument,  0,  'i' },
+    { "output",  required_argument,  0,  'o' },
+    {  "phase",  required_argument,  0,  'p' },
+    {    "run",  required_argument,  0,  'r' },
+    {  "width",  required_argument,  0,  'w' },
+    { "height",  required_argument,  0,  'h' },
+    {"threads",  required_argument,  0,  't' },
+    {        0,                  0,  0,   0  }
+  };
+
+  while((opt = getopt_long(argc, argv, ":i:o:p:r:w:h:t:", long_options, &opt_index)) != -1)
+  {
+    switch(opt)
+    {
+      case 'i': input = optarg; break;
+      case 'o': output = optarg; break;
+      case 'p': phase = atoi(optarg); break;
+      case 'r': run = atoi(optarg); break;
+      case 'w': width = strtoull(optarg, nullptr, 10); break;
+      case 'h': height = strtoull(optarg, nullptr, 10); break;
+      case 't': threads = atoi(optarg); break;
+      case ':':
+        printf("option needs a value\n");
+        exit(1);
+      case '?':
+        printf("unknown option: %c\n", optopt);
+        exit(1);
+    }
+  }
+  if(input.empty()) {
+    printf("Usage: render --input export.bin [--output out.png|out.ppm --phase p --run n --width w --height h --threads t]\n");
+    exit(1);
+  }
+  if(phase < 0 || phase > 2) {
+    printf("phase must be 0, 1 or 2\n");
+    exit(1);
+  }
+  if(threads == 0) threads = 1;
+  if(width == 0) width = 1;
+
+  //pick the run and pull out the requested phase
+  ExportReader reader;
+  ExportReader::Interval interval;
+  vector<Row> rows;
+  int region_bits = 0;
+  int current = -1;
+
+  if(!reader.open(input)) {
+    cout << RED << "could not open " << input << RESET << endl;
+    exit(1);
+  }
+  while(reader.next_run()) {
+    current++;
+    if(run >= 0 && current != run) continue;
+    rows.clear();
+    region_bits = reader.region_bits[phase];
+    while(reader.next_interval(interval)) {
+      rows.emplace_back();
+      for(auto& p : interval.phases) {
+        if(p.phase == phase) rows.back().entries.swap(p.entries);
+      }
+    }
+    if(run >= 0) break;
+  }
+  if(rows.empty()) {
+    cout << RED << "no intervals found" << RESET << endl;
+    exit(1);
+  }
+
+  //address range that was ever non-zero
+  uint64_t lo = ~0ULL, hi = 0;
+  for(auto& r : rows) {
+    if(r.entries.empty()) continue;
+    lo = min(lo, r.entries.front().first);
+    hi = max(hi, r.entries.back().first);
+  }
+  if(lo > hi) {
+    cout << RED << "phase " << phase << " has no counts" << RESET << endl;
+    exit(1);
+  }
+  uint64_t span = hi - lo + 1;
+  uint64_t intervals = rows.size();
+  uint64_t cols = min(width, span);
+  uint64_t lines = height ? min(height, intervals) : min((uint64_t)4096, intervals);
+  vector<double> grid(cols*lines);
+  vector<double> band_max(threads);
+  vector<thread> pool;
+  unsigned t;
+
+  //each thread owns a band of image rows and the intervals that fold into them
+  auto accumulate = [&](unsigned id) {
+    uint64_t y0 = lines*id/threads;
+    uint64_t y1 = lines*(id+1)/threads;
+    uint64_t first = (y0*intervals + lines-1)/lines;
+    uint64_t i, y;
+    double peak = 0;
+
+    for(i=first; i<intervals; i++) {
+      y = i*lines/intervals;
+      if(y >= y1) break;
+      double* line = &grid[y*cols];
+      for(auto& e : rows[i].entries) {
+        line[(unsigned __int128)(e.first-lo)*cols/span] += e.second;
+      }
+    }
+    for(i=y0*cols; i<y1*cols; i++) peak = max(peak, grid[i]);
+    band_max[id] = peak;
+  };
+  for(t=0; t<threads; t++) pool.emplace_back(accumulate, t);
+  for(auto& th : pool) th.join();
+  pool.clear();
+
+  double peak = *max_element(band_max.begin(), band_max.end());
+  double scale = peak > 0 ? 1.0/log1p(peak) : 0;
+  vector<unsigned char> rgb(cols*lines*3);
+
+  auto colorize = [&](unsigned id) {
+    uint64_t i0 = cols*lines*id/threads;
+    uint64_t i1 = cols*lines*(id+1)/threads;
+    for(uint64_t i=i0; i<i1; i++) heat_color(log1p(grid[i])*scale, &rgb[i*3]);
+  };
+  for(t=0; t<threads; t++) pool.emplace_back(colorize, t);
+  for(auto& th : pool) th.join();
+
+  FILE* f = fopen(output.c_str(), "wb");
+  if(!f) {
+    cout << RED << "could not open " << output << RESET << endl;
+    exit(1);
+  }
+  if(output.size() > 4 && output.compare(output.size()-4, 4, ".ppm") == 0) {
+    fprintf(f, "P6\n%llu %llu\n255\n", (unsigned long long)cols, (unsigned long long)lines);
+    fwrite(rgb.data(), 1, rgb.size(), f);
+  }else{
+    write_png(f, rgb, cols, lines);
+  }
+  fclose(f);
+
+  cout << "Phase: " << GREEN << phase << RESET
+    << "  Intervals: " << GREEN << intervals << RESET
+    << "  Image: " << GREEN << cols << "x" << lines << RESET
+    << "  Addresses: " << GREEN << hex << (lo << region_bits) << "-" << ((hi+1) << region_bits) << dec << RESET
+    << "  Peak: " << GREEN << (uint64_t)peak << RESET << endl;
+  exit(0);
+}
@@ -0,0 +1,287 @@
+/* File: report.h
+ * Author: Zach McMichael
+ * Description: formats the per interval table and the run summary into
+ *				a preallocated buffer that a background thread flushes
+ */
+
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <cstdio>
+#include <cstdarg>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "async_writer.h"
+
+#ifndef RESET
+#define RESET   "\033[0m"
+#define RED     "\033[31m"
+#define GREEN   "\033[32m"
+#define MAGENTA "\033[35m"
+#define CYAN    "\033[36m"
+#endif
+
+using namespace std;
+
+class Report {
+
+  public:
+    enum Format { TABLE, CSV, TSV };
+
+    Format format = TABLE;
+    int color = 1; //ansi colors, table format only
+    int fixed2 = 0; //summary percentages as %.2f instead of %g
+
+    /* open: start the writer
+     * Parameters: string the output file, "-" for stdout
+     *             Format the row format
+     *             int 1 to use colors
+     * Returns: bool false if the file could not be opened
+     */
+    bool open(string name, Format f, int use_color) {
+      format = f;
+      color = (f == TABLE) && use_color;
+      return out.open(name, "w", 1 << 16);
+    }
+
+    /* parse_format: turn a --format argument into a Format
+     * Parameters: string table, csv or tsv
+     *             Format& where to put it
+     * Returns: bool false if the name is unknown
+     */
+    static bool parse_format(string name, Format& f) {
+      if(name == "table") f = TABLE;
+      else if(name == "csv") f = CSV;
+      else if(name == "tsv") f = TSV;
+      else return false;
+      return true;
+    }
+
+    /* add_column: add a column to the interval table
+     * Parameters: const char* the table heading
+     *             const char* the csv/tsv heading
+     *             int the table width
+     * Returns: None
+     */
+    void add_column(const char* title, const char* name, int width) {
+      columns.push_back({title, name, width});
+    }
+
+    /* header: print the column headings
+     * Parameters: None
+     * Returns: None
+     */
+    void header() {
+      size_t i;
+
+      if(format == TABLE) {
+        build_rule();
+        text("%s%s\n |", c(RESET), rule_line.c_str());
+        for(i=0; i<columns.size(); i++) {
+          emit("%*s |", columns[i].width, columns[i].title);
+        }
+        text("\n%s\n", rule_line.c_str());
+      }else{
+        for(i=0; i<columns.size(); i++) {
+          emit("%s%s", i ? delim() : "", columns[i].name);
+        }
+        text("\n");
+      }
+    }
+
+    /* rule: print the separator line between intervals, table format only
+     * Parameters: None
+     * Returns: None
+     */
+    void rule() {
+      if(format == TABLE) text("%s\n", rule_line.c_str());
+    }
+
+    void begin_row() {
+      col = 0;
+      colored = false;
+      if(format == TABLE) emit("%s |", c(RESET));
+    }
+
+    void end_row() {
+      if(format == TABLE && colored) emit("%s", c(RESET));
+      text("\n");
+    }
+
+    /* cell: print one value into the next column
+     * Parameters: the value, precision for doubles, and an optional color
+     * Returns: None
+     */
+    void cell(uint64_t v) {
+      start_cell(nullptr);
+      if(format == TABLE) emit("%*llu |", width(), (unsigned long long)v);
+      else emit("%llu", (unsigned long long)v);
+      col++;
+    }
+
+    void cell(double v, int precision, const char* code = nullptr) {
+      start_cell(code);
+      if(format == TABLE) emit("%*.*f |", width(), precision, v);
+      else emit("%.*f", precision, v);
+      col++;
+    }
+
+    void cell(const char* v) {
+      start_cell(nullptr);
+      if(format == TABLE) emit("%*s |", width(), v);
+      else emit("%s", v);
+      col++;
+    }
+
+    void blank() {
+      start_cell(nullptr);
+      if(format == TABLE) emit("%*s |", width(), " ");
+      col++;
+    }
+
+    /* blank_until: blank the columns up to the last few of the row
+     * Parameters: size_t how many columns to leave
+     * Returns: None
+     */
+    void blank_until(size_t left) {
+      while(col + left < columns.size()) blank();
+    }
+
+    /* label: a value the table only shows on some rows, machine formats
+     *        repeat it on every row so each line stands alone
+     * Parameters: uint64_t the value
+     *             bool show it in the table
+     * Returns: None
+     */
+    void label(uint64_t v, bool show) {
+      if(show || format != TABLE) cell(v);
+      else blank();
+    }
+
+    /* text: printf into the buffer, summary lines are comments in csv/tsv
+     * Parameters: const char* format and arguments
+     * Returns: None
+     */
+    void text(const char* fmt, ...) {
+      va_list args;
+      va_start(args, fmt);
+      vemit(fmt, args);
+      va_end(args);
+    }
+
+    void summary(const char* fmt, ...) {
+      va_list args;
+      if(format != TABLE) emit("# ");
+      va_start(args, fmt);
+      vemit(fmt, args);
+      va_end(args);
+    }
+
+    /* pct: format a summary percentage the way the table always has
+     * Parameters: double the value
+     * Returns: const char* a static buffer
+     */
+    const char* pct(double v) {
+      snprintf(pct_buf, sizeof(pct_buf), fixed2 ? "%.2f" : "%g", v);
+      return pct_buf;
+    }
+
+    /* c: an ansi code, or nothing when colors are off
+     * Parameters: const char* the code
+     * Returns: const char* the code or ""
+     */
+    const char* c(const char* code) {
+      return color ? code : "";
+    }
+
+    void flush() {
+      out.flush();
+    }
+
+    //wait until everything emitted so far is written, before printing around the writer
+    void drain() {
+      out.drain();
+    }
+
+    //most bytes of rows that waited on a slow output at once
+    uint64_t backlog_peak() const {
+      return out.peak_queued;
+    }
+
+    //write every row in the caller as it is emitted, for --debug output
+    void synchronous() {
+      out.sync = true;
+    }
+
+    void close() {
+      out.close();
+    }
+
+  private:
+    struct Column {
+      const char* title;
+      const char* name;
+      int width;
+    };
+
+    AsyncWriter out;
+    vector<Column> columns;
+    string rule_line;
+    size_t col = 0;
+    bool colored = false; //the last cell switched color
+    char pct_buf[32];
+
+    int width() {
+      return col < columns.size() ? columns[col].width : 0;
+    }
+
+    const char* delim() {
+      return format == CSV ? "," : "\t";
+    }
+
+    void build_rule() {
+      size_t dashes = 0;
+      for(auto& column : columns) dashes += column.width + 2;
+      rule_line = " |" + string(dashes ? dashes-1 : 0, '-') + "|";
+    }
+
+    void start_cell(const char* code) {
+      if(format != TABLE) {
+        if(col) emit("%s", delim());
+        return;
+      }
+      if(code && color) {
+        emit("%s", code);
+        colored = true;
+      }else if(colored) {
+        emit("%s", c(RESET));
+        colored = false;
+      }
+    }
+
+    void emit(const char* fmt, ...) {
+      va_list args;
+      va_start(args, fmt);
+      vemit(fmt, args);
+      va_end(args);
+    }
+
+    void vemit(const char* fmt, va_list args) {
+      va_list copy;
+      size_t room = 256;
+      int used;
+
+      va_copy(copy, args);
+      used = vsnprintf(out.reserve_tail(room), room, fmt, args);
+      if(used >= (int)room) {
+        out.commit(0);
+        room = used + 1;
+        used = vsnprintf(out.reserve_tail(room), room, fmt, copy);
+      }
+      va_end(copy);
+      out.commit(used > 0 ? used : 0);
+    }
+};
+
+#endif
@@ -0,0 +1,294 @@
+/* File: ring.h
+ * Author: Zach McMichael
+ * Description: single producer, single consumer ring of binary (time,
+ *				addr) records in POSIX shared memory, so a co-running
+ *				tracer can feed heatmap without a text round trip
+ *
+ * Layout of the shared memory object, all integers little endian:
+ *   RingHeader, 256 bytes:
+ *     0    uint64_t  magic, the bytes "HMRING1", stored last with release
+ *     8    uint64_t  capacity, records, a power of two
+ *     16   uint64_t  record_bytes, sizeof(RingRecord) = 16
+ *     24   uint64_t  header_bytes, 256
+ *     64   uint64_t  head, records ever written, only the producer stores
+ *     128  uint64_t  tail, records ever consumed, only the consumer stores
+ *     192  uint64_t  dropped, records the producer threw away when full
+ *     200  uint64_t  stalls, times the producer waited for room
+ *     208  uint32_t  done, set by the producer after its last record
+ *   then capacity RingRecords {double time; uint64_t addr;}
+ * Record i lives in slot i & (capacity-1). The producer writes the slot
+ * then stores head with release, the consumer loads head with acquire,
+ * reads the slots in place and stores tail with release to hand them back.
+ */
+
+#ifndef RING_H
+#define RING_H
+
+#include <cstdint>
+#include <string>
+#include <atomic>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+struct RingRecord {
+  double time; //seconds
+  uint64_t addr; //physical address
+};
+
+//"HMRING1" read as a little endian uint64_t
+static const uint64_t RING_MAGIC = 0x0031474e49524d48ULL;
+
+struct RingHeader {
+  atomic<uint64_t> magic;
+  uint64_t capacity;
+  uint64_t record_bytes;
+  uint64_t header_bytes;
+  alignas(64) atomic<uint64_t> head;
+  alignas(64) atomic<uint64_t> tail;
+  alignas(64) atomic<uint64_t> dropped;
+  atomic<uint64_t> stalls;
+  atomic<uint32_t> done;
+};
+
+static_assert(sizeof(RingHeader) <= 256, "ring header must fit in 256 bytes");
+static_assert(atomic<uint64_t>::is_always_lock_free, "ring needs lock free 64 bit atomics");
+
+class ShmRing {
+
+  public:
+    static const uint64_t HEADER_BYTES = 256;
+
+    uint64_t waits = 0; //times the consumer found the ring empty
+
+    ~ShmRing() {
+      close();
+    }
+
+    /* create: make a new ring, replacing a stale one of the same name
+     * Parameters: string the shm name, a leading / is added if missing
+     *             uint64_t records, rounded up to a power of two
+     *             string& why it failed
+     * Returns: bool false if it could not be made
+     */
+    bool create(string name, uint64_t capacity, string& error) {
+      uint64_t cap = 1;
+      int fd;
+
+      while(cap < capacity) cap <<= 1;
+      path = shm_path(name);
+      shm_unlink(path.c_str());
+      fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if(fd < 0) {
+        error = "could not create shared memory " + path;
+        return false;
+      }
+      bytes = HEADER_BYTES + cap*sizeof(RingRecord);
+      if(ftruncate(fd, bytes) != 0 || !map(fd)) {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        error = "could not size shared memory " + path;
+        return false;
+      }
+      ::close(fd);
+      owner = true;
+
+      h = new (base) RingHeader();
+      h->capacity = cap;
+      h->record_bytes = sizeof(RingRecord);
+      h->header_bytes = HEADER_BYTES;
+      h->head.store(0, memory_order_relaxed);
+      h->tail.store(0, memory_order_relaxed);
+      h->dropped.store(0, memory_order_relaxed);
+      h->stalls.store(0, memory_order_relaxed);
+      h->done.store(0, memory_order_relaxed);
+      h->magic.store(RING_MAGIC, memory_order_release);
+      setup_slots();
+      return true;
+    }
+
+    /* attach: open a ring someone else created, waiting for it to appear
+     * Parameters: string the shm name
+     *             double seconds to keep trying
+     *             string& why it failed
+     * Returns: bool false if no valid ring showed up in time
+     */
+    bool attach(string name, double timeout, string& error) {
+      struct stat st;
+      double waited = 0;
+      int fd;
+
+      path = shm_path(name);
+      for(;;) {
+        fd = shm_open(path.c_str(), O_RDWR, 0);
+        if(fd >= 0 && fstat(fd, &st) == 0 && (uint64_t)st.st_size > HEADER_BYTES) {
+          bytes = st.st_size;
+          if(map(fd)) {
+            h = (RingHeader*)base;
+            if(h->magic.load(memory_order_acquire) == RING_MAGIC && h->record_bytes == sizeof(RingRecord)
+                && HEADER_BYTES + h->capacity*sizeof(RingRecord) <= bytes) {
+              ::close(fd);
+              setup_slots();
+              return true;
+            }
+            munmap(base, bytes);
+            base = nullptr;
+          }
+        }
+        if(fd >= 0) ::close(fd);
+        if(waited >= timeout) break;
+        pause(10000000);
+        waited += 0.01;
+      }
+      error = "no ring at " + path;
+      return false;
+    }
+
+    /* push: producer side, append one record
+     * Parameters: double the timestamp
+     *             uint64_t the address
+     *             bool drop the record when full instead of waiting
+     * Returns: bool false if it was dropped
+     */
+    bool push(double time, uint64_t addr, bool drop) {
+      uint64_t head = h->head.load(memory_order_relaxed);
+
+      if(head - cached_tail >= capacity) {
+        cached_tail = h->tail.load(memory_order_acquire);
+        if(head - cached_tail >= capacity) {
+          if(drop) {
+            h->dropped.fetch_add(1, memory_order_relaxed);
+            return false;
+          }
+          h->stalls.fetch_add(1, memory_order_relaxed);
+          while(head - cached_tail >= capacity) {
+            pause(20000);
+            cached_tail = h->tail.load(memory_order_acquire);
+          }
+        }
+      }
+      slots[head & mask] = {time, addr};
+      h->head.store(head+1, memory_order_release);
+      return true;
+    }
+
+    /* finish: producer side, tell the consumer nothing more is coming
+     * Parameters: None
+     * Returns: None
+     */
+    void finish() {
+      h->done.store(1, memory_order_release);
+    }
+
+    /* next: consumer side, read the next record in place, waiting while the
+     *       ring is empty and the producer is not done
+     * Parameters: double& the timestamp
+     *             uint64_t& the address
+     * Returns: bool false once the producer is done and the ring is drained
+     */
+    bool next(double& time, uint64_t& addr) {
+      if(pos == limit) {
+        h->tail.store(pos, memory_order_release);
+        released = pos;
+        while((limit = h->head.load(memory_order_acquire)) == pos) {
+          if(h->done.load(memory_order_acquire)) {
+            limit = h->head.load(memory_order_acquire);
+            if(limit == pos) return false;
+            break;
+          }
+          waits++;
+          pause(50000);
+        }
+      }else if(pos - released >= release_every) {
+        //hand slots back in chunks so a full ring does not wait a whole lap
+        h->tail.store(pos, memory_order_release);
+        released = pos;
+      }
+      const RingRecord& r = slots[pos & mask];
+      time = r.time;
+      addr = r.addr;
+      pos++;
+      return true;
+    }
+
+    uint64_t dropped() {
+      return h ? h->dropped.load(memory_order_relaxed) : 0;
+    }
+
+    uint64_t stalls() {
+      return h ? h->stalls.load(memory_order_relaxed) : 0;
+    }
+
+    uint64_t consumed() {
+      return pos;
+    }
+
+    uint64_t size() {
+      return capacity;
+    }
+
+    /* close: unmap, and remove the name if this side created it
+     * Parameters: None
+     * Returns: None
+     */
+    void close() {
+      if(base) munmap(base, bytes);
+      if(owner) shm_unlink(path.c_str());
+      base = nullptr;
+      h = nullptr;
+      owner = false;
+    }
+
+  private:
+    string path;
+    void* base = nullptr;
+    uint64_t bytes = 0;
+    bool owner = false;
+    RingHeader* h = nullptr;
+    RingRecord* slots = nullptr;
+    uint64_t capacity = 0;
+    uint64_t mask = 0;
+    uint64_t cached_tail = 0; //producer's last look at tail
+    uint64_t pos = 0; //consumer's next record
+    uint64_t limit = 0; //consumer's last look at head
+    uint64_t released = 0; //consumer's last tail store
+    uint64_t release_every = 0;
+
+    static string shm_path(string name) {
+      return (!name.empty() && name[0] == '/') ? name : "/" + name;
+    }
+
+    static void pause(long ns) {
+      struct timespec ts = {0, ns};
+      sched_yield();
+      nanosleep(&ts, nullptr);
+    }
+
+    bool map(int fd) {
+      base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if(base == MAP_FAILED) {
+        base = nullptr;
+        return false;
+      }
+      return true;
+    }
+
+    void setup_slots() {
+      capacity = h->capacity;
+      mask = capacity-1;
+      slots = (RingRecord*)((char*)base + HEADER_BYTES);
+      cached_tail = h->tail.load(memory_order_acquire);
+      pos = cached_tail;
+      limit = pos;
+      released = pos;
+      release_every = capacity/16 ? capacity/16 : 1;
+    }
+};
+
+#endif
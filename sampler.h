@@ -0,0 +1,130 @@
+/* File: sampler.h
+ * Author: Zach McMichael
+ * Description: SHARDS style spatial sampling, a record is kept only when
+ *				the hash of its finest phase region falls under a fixed
+ *				threshold, so every region is either fully sampled or
+ *				skipped and the sampled counts scale back up by 1/rate
+ *
+ * Sampling whole regions makes the estimate a Horvitz-Thompson sum over
+ * the sampled regions, N = sum(c_r)/R, with the unbiased variance estimate
+ * (1-R)/R^2 * sum(c_r^2). The bound reported is 1.96 standard deviations.
+ * Every count heatmap prints, interval rows and totals, is scaled by the
+ * same 1/R so they all estimate the full trace the same way.
+ */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <istream>
+#include <unordered_map>
+#include <math.h>
+
+using namespace std;
+
+class Sampler {
+
+  public:
+    int enabled = 0; //only drop records when --sample-rate is passed
+    double rate = 1; //fraction of regions kept
+    int shift = 0; //log2 of the sampled region size
+    uint64_t threshold = 0; //hashes below this are kept
+    uint64_t seen = 0; //records offered
+    uint64_t kept = 0; //records sampled
+    unordered_map<uint64_t, uint64_t> regions; //sampled region to records counted
+
+    /* setup: pick the threshold for a sampling rate
+     * Parameters: double fraction of regions to keep, 0 to 1
+     *             int log2 of the region size that is sampled as a whole
+     * Returns: None
+     */
+    void setup(double r, int region_bits) {
+      rate = r;
+      shift = region_bits;
+      threshold = (r >= 1) ? UINT64_MAX : (uint64_t)(r*18446744073709551616.0);
+    }
+
+    /* keep: decide from the address alone if a record is sampled
+     * Parameters: uint64_t the address
+     * Returns: bool true if it should be counted
+     */
+    bool keep(uint64_t addr) {
+      seen++;
+      if(mix(addr >> shift) >= threshold) return false;
+      kept++;
+      return true;
+    }
+
+    /* next_line: read whole lines until one is sampled, a line without an
+     *            address field is skipped like an unsampled one
+     * Parameters: istream& the dataset, after the column names
+     *             string& the sampled line
+     *             uint64_t& its address
+     *             uint64_t& byte offset, moved past the skipped lines
+     * Returns: bool false at the end of the dataset
+     */
+    bool next_line(istream& in, string& line, uint64_t& addr, uint64_t& offset) {
+      size_t comma;
+
+      while(getline(in, line)) {
+        comma = line.find(',');
+        if(comma != string::npos) {
+          addr = strtoull(line.c_str()+comma+1, nullptr, 16);
+          if(keep(addr)) return true;
+        }
+        offset += line.size() + 1;
+      }
+      return false;
+    }
+
+    /* count: note a sampled record that was counted
+     * Parameters: uint64_t the address
+     * Returns: None
+     */
+    void count(uint64_t addr) {
+      regions[addr >> shift]++;
+    }
+
+    //the Horvitz-Thompson estimate of a sampled count, what bound() is for
+    double estimate(uint64_t sampled) const {
+      return sampled/rate;
+    }
+
+    //estimate() rounded for the interval rows
+    uint64_t scaled(uint64_t sampled) const {
+      return enabled ? (uint64_t)llround(sampled/rate) : sampled;
+    }
+
+    /* bound: half width of the 95% confidence interval of estimate(counted)
+     * Parameters: None
+     * Returns: double accesses
+     */
+    double bound() const {
+      double squares = 0;
+
+      for(auto& r : regions) squares += (double)r.second*r.second;
+      return 1.96*sqrt((1-rate)/(rate*rate)*squares);
+    }
+
+    uint64_t counted() const {
+      uint64_t total = 0;
+
+      for(auto& r : regions) total += r.second;
+      return total;
+    }
+
+  private:
+    //splitmix64 finalizer, spreads neighbouring regions over the whole range
+    static uint64_t mix(uint64_t x) {
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ULL;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebULL;
+      x ^= x >> 31;
+      return x;
+    }
+};
+
+#endif
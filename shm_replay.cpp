@@ -0,0 +1,112 @@
+/* File: shm_replay.cpp
+ * Author: Zach McMichael
+ * Description: replays a recorded time,phys_addr dataset into a heatmap
+ *				--shm ring, as fast as possible or paced to its timestamps
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <time.h>
+#include <getopt.h>
+#include "ring.h"
+
+using namespace std;
+
+/* now_s: the monotonic clock in seconds
+ * Parameters: None
+ * Returns: double seconds
+ */
+double now_s() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+int main(int argc, char* argv[]) {
+  int opt;
+  int opt_index = 0;
+  string input = "";
+  string shm = "";
+  double speed = 0; //trace seconds per wall second, 0 for as fast as possible
+  bool drop = false;
+  double timeout = 10;
+
+  static struct option long_options[] = {
+    {  "input",  required_argument,  0,  'i' },
+    {    "shm",  required_argument,  0,  'm' },
+    {  "speed",  required_argument,  0,  's' },
+    {   "drop",        no_argument,  0,  'D' },
+    {"timeout",  required_argument,  0,  't' },
+    {        0,                  0,  0,   0  }
+  };
+
+  while((opt = getopt_long(argc, argv, ":i:m:s:Dt:", long_options, &opt_index)) != -1)
+  {
+    switch(opt)
+    {
+      case 'i': input = optarg; break;
+      case 'm': shm = optarg; break;
+      case 's': speed = atof(optarg); break;
+      case 'D': drop = true; break;
+      case 't': timeout = atof(optarg); break;
+      case ':':
+        printf("option needs a value\n");
+        exit(1);
+      case '?':
+        printf("unknown option: %c\n", optopt);
+        exit(1);
+    }
+  }
+  if(input.empty() || shm.empty()) {
+    printf("Usage: shm_replay --input trace.csv --shm name [--speed x --drop --timeout s]\n");
+    exit(1);
+  }
+
+  FILE* in = fopen(input.c_str(), "r");
+  if(!in) {
+    printf("could not open %s\n", input.c_str());
+    exit(1);
+  }
+
+  ShmRing ring;
+  string error;
+  if(!ring.attach(shm, timeout, error)) {
+    printf("%s\n", error.c_str());
+    exit(1);
+  }
+
+  char line[256];
+  char* comma;
+  double time, first = 0, start = now_s(), ahead;
+  uint64_t addr, records = 0;
+  struct timespec ts;
+
+  if(!fgets(line, sizeof(line), in)) line[0] = 0; //remove column names
+  while(fgets(line, sizeof(line), in)) {
+    time = strtod(line, &comma);
+    if(*comma != ',') continue;
+    addr = strtoull(comma+1, nullptr, 16);
+    if(records == 0) first = time;
+
+    //sleep until the trace catches up with the wall clock
+    if(speed > 0) {
+      ahead = (time - first)/speed - (now_s() - start);
+      if(ahead > 0.001) {
+        ts.tv_sec = (time_t)ahead;
+        ts.tv_nsec = (long)((ahead - ts.tv_sec)*1e9);
+        nanosleep(&ts, nullptr);
+      }
+    }
+    ring.push(time, addr, drop);
+    records++;
+  }
+  ring.finish();
+  fclose(in);
+
+  printf("records %llu  dropped %llu  stalls %llu  seconds %.3f\n", (unsigned long long)records,
+    (unsigned long long)ring.dropped(), (unsigned long long)ring.stalls(), now_s() - start);
+  exit(0);
+}
@@ -0,0 +1,160 @@
+/* File: sliding_window.h
+ * Author: Zach McMichael
+ * Description: exact access counts at the finest phase granularity over the
+ *				last few seconds, slid forward one interval at a time
+ *
+ * Each interval's counts are kept as a sparse delta of just the regions it
+ * touched, in a ring as long as the window. A slide adds the newest delta
+ * to the window totals and subtracts the ones that fell out, so it costs
+ * the regions those intervals touched, never a recount of the window. An
+ * interval is in the window while any of it overlaps the last --window
+ * seconds, so the window is always a whole number of intervals.
+ */
+
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+class SlidingWindow {
+
+  public:
+    int enabled = 0; //only keep deltas when --window is passed
+    double length = 0; //seconds the window covers
+    int shift = 0; //log2 of the region size counted
+    unordered_map<uint64_t, uint64_t> totals; //region number to accesses in the window
+    uint64_t accesses = 0; //accesses in the window
+
+    //over the whole run
+    uint64_t slides = 0;
+    uint64_t entries_applied = 0; //delta entries added plus subtracted
+    uint64_t peak_regions = 0;
+    uint64_t peak_intervals = 0;
+
+    /* setup: pick the window length and the region size
+     * Parameters: double seconds the window covers
+     *             int log2 of the region size counted
+     * Returns: None
+     */
+    void setup(double seconds, int region_bits) {
+      length = seconds;
+      shift = region_bits;
+    }
+
+    /* access: count one access into the current interval's delta
+     * Parameters: uint64_t the address
+     * Returns: None
+     */
+    void access(uint64_t addr) {
+      current[addr >> shift]++;
+    }
+
+    /* slide: close the current interval and move the window to end with it
+     * Parameters: double the timestamp the interval ended at
+     * Returns: None
+     */
+    void slide(double time) {
+      Delta& d = push();
+      uint64_t n;
+
+      d.end = time;
+      d.accesses = 0;
+      d.counts.assign(current.begin(), current.end());
+      current.clear();
+      for(auto& c : d.counts) {
+        totals[c.first] += c.second;
+        d.accesses += c.second;
+      }
+      accesses += d.accesses;
+      entries_applied += d.counts.size();
+
+      //the newest interval always stays, it ends at time
+      while(used > 1 && ring[head].end <= time - length) {
+        Delta& old = ring[head];
+        for(auto& c : old.counts) {
+          auto t = totals.find(c.first);
+          n = t->second - c.second;
+          if(n) t->second = n;
+          else totals.erase(t);
+        }
+        accesses -= old.accesses;
+        entries_applied += old.counts.size();
+        old.counts.clear();
+        head = (head+1) % ring.size();
+        used--;
+      }
+      slides++;
+      peak_regions = max(peak_regions, (uint64_t)totals.size());
+      peak_intervals = max(peak_intervals, (uint64_t)used);
+    }
+
+    uint64_t intervals() const {
+      return used;
+    }
+
+    /* top_coverage: percent of the window's accesses in its k hottest regions
+     * Parameters: uint64_t how many regions, the finest phase holds
+     * Returns: double percent
+     */
+    double top_coverage(uint64_t k) {
+      uint64_t sum = 0;
+
+      if(accesses == 0) return 0;
+      scratch.clear();
+      for(auto& t : totals) scratch.push_back(t.second);
+      if(k < scratch.size()) {
+        nth_element(scratch.begin(), scratch.begin()+k, scratch.end(), greater<uint64_t>());
+        scratch.resize(k);
+      }
+      for(auto c : scratch) sum += c;
+      return 100.0*sum/accesses;
+    }
+
+    /* hottest: the region with the most accesses in the window
+     * Parameters: None
+     * Returns: uint64_t its base address, 0 for an empty window
+     */
+    uint64_t hottest() const {
+      uint64_t region = 0, best = 0;
+
+      for(auto& t : totals) {
+        if(t.second > best || (t.second == best && t.first < region)) {
+          best = t.second;
+          region = t.first;
+        }
+      }
+      return region << shift;
+    }
+
+  private:
+    struct Delta {
+      double end; //timestamp the interval ended at
+      uint64_t accesses;
+      vector<pair<uint64_t, uint64_t>> counts; //(region number, accesses) it touched
+    };
+
+    vector<Delta> ring; //grows to the most intervals a window ever held
+    size_t head = 0; //oldest delta
+    size_t used = 0;
+    unordered_map<uint64_t, uint64_t> current; //the interval being counted
+    vector<uint64_t> scratch;
+
+    //slot for a new delta, reusing the storage of expired ones
+    Delta& push() {
+      if(used == ring.size()) {
+        //unroll so the oldest is at the front again before growing
+        rotate(ring.begin(), ring.begin()+head, ring.end());
+        head = 0;
+        ring.emplace_back();
+      }
+      return ring[(head + used++) % ring.size()];
+    }
+};
+
+#endif
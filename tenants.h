@@ -0,0 +1,139 @@
+/* File: tenants.h
+ * Author: Zach McMichael
+ * Description: one phase cascade per address space, keyed by a PID or
+ *				ASID column of the trace, inside a global memory budget
+ *
+ * Every tenant is a copy of a freshly set up Global, so it runs the same
+ * phases and warms up on its own from the interval it first appears in.
+ * Tenants that would go over the budget share one overflow tracker.
+ */
+
+#ifndef TENANTS_H
+#define TENANTS_H
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include "heatmap.h"
+
+using namespace std;
+
+class Tenants {
+
+  public:
+    struct Tenant {
+      uint64_t id; //pid or asid, OVERFLOW for the shared tracker
+      Global G; //its own phases
+      uint64_t iteration = 0; //boundaries it has seen
+      uint64_t accesses = 0; //over the whole run
+    };
+
+    static const uint64_t OVERFLOW = ~0ULL;
+
+    int enabled = 0; //only split by address space when --tenants is passed
+    int column = 2; //trace column holding the pid or asid
+    uint64_t budget = 64ULL << 20; //bytes all tenant trackers may use
+    uint64_t tenant_bytes = 0; //bytes one tracker can grow to
+    vector<unique_ptr<Tenant>> tenants; //in the order they first appeared
+    uint64_t overflowed = 0; //address spaces that went to the overflow tracker
+
+    /* setup: remember a set up tracker to copy for every tenant, sized by
+     *        what its tables really hold with the backend and heat mode
+     * Parameters: Global& the tracker after setup(), before any access
+     * Returns: bool false if the budget can not hold one tenant and the
+     *          overflow tracker
+     */
+    bool setup(const Global& G) {
+      int p;
+
+      proto = G;
+      tenant_bytes = 0;
+      for(p=0; p<3; p++) {
+        uint64_t slots = G.num_cache_regions[p] + G.extra_regions[p];
+        //the tables are only grown to take seed slots at the first rebuild
+        tenant_bytes += G.counter_bytes(p)*slots/G.num_cache_regions[p];
+        if(p) tenant_bytes += slots*(sizeof(pair<const uint64_t, uint64_t>) + 4*sizeof(void*));
+      }
+      return budget >= 2*tenant_bytes;
+    }
+
+    /* find: the tracker for an address space, made on first use
+     * Parameters: uint64_t the pid or asid
+     * Returns: Tenant& its tracker, or the overflow tracker past the budget
+     */
+    Tenant& find(uint64_t id) {
+      if(last && last->id == id) return *last;
+      auto it = by_id.find(id);
+      if(it != by_id.end()) {
+        last = tenants[it->second].get();
+        return *last;
+      }
+
+      //leave room for the overflow tracker
+      if((tenants.size() + (overflow ? 1 : 2))*tenant_bytes > budget) {
+        if(!overflow) overflow = add(OVERFLOW);
+        by_id[id] = overflow_index;
+        overflowed++;
+        last = overflow;
+        return *last;
+      }
+      last = add(id);
+      return *last;
+    }
+
+    /* record: count one access against its address space
+     * Parameters: uint64_t the pid or asid
+     *             uint64_t the address
+     *             bool the access was a write
+     *             uint64_t its weight
+     * Returns: None
+     */
+    void record(uint64_t id, uint64_t addr, bool write, uint64_t weight) {
+      Tenant& t = find(id);
+      t.accesses++;
+      if(t.G.heat_mode == HEAT_COUNT) t.G.record(addr);
+      else t.G.record_weighted(addr, write, weight);
+    }
+
+    /* end_interval: fold every tenant's interval into its totals and
+     *               rebuild its phases
+     * Parameters: None
+     * Returns: None
+     */
+    void end_interval() {
+      int p;
+
+      for(auto& t : tenants) {
+        for(p=0; p<3; p++) {
+          t->G.total_cache_hits[p] += t->G.cache_hits[p];
+          t->G.total_cache_misses[p] += t->G.cache_misses[p];
+          t->G.total_counter_inc[p] += t->G.counter_inc[p];
+          t->G.total_counter_dec[p] += t->G.counter_dec[p];
+          t->G.cache_hits[p] = 0;
+          t->G.cache_misses[p] = 0;
+          t->G.counter_inc[p] = 0;
+          t->G.counter_dec[p] = 0;
+        }
+        t->iteration++;
+        t->G.heatmap(t->iteration);
+      }
+    }
+
+  private:
+    Global proto;
+    map<uint64_t, size_t> by_id; //pid or asid to index in tenants
+    Tenant* last = nullptr; //traces tend to run one tenant at a time
+    Tenant* overflow = nullptr;
+    size_t overflow_index = 0;
+
+    Tenant* add(uint64_t id) {
+      tenants.emplace_back(new Tenant{id, proto});
+      if(id == OVERFLOW) overflow_index = tenants.size()-1;
+      else by_id[id] = tenants.size()-1;
+      return tenants.back().get();
+    }
+};
+
+#endif
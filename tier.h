@@ -0,0 +1,136 @@
+/* File: tier.h
+ * Author: Zach McMichael
+ * Description: two tier memory placement simulator, the hottest finest
+ *				phase regions of one interval are placed in the fast tier
+ *				for the next and every access is charged that tier's latency
+ */
+
+#ifndef TIER_H
+#define TIER_H
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include "hugepage.h"
+
+using namespace std;
+
+class TierSim {
+
+  public:
+    int enabled = 0; //only simulate when --tier-capacity is passed
+    uint64_t capacity = 0; //fast tier size in bytes
+    double fast_ns = 80; //load latency of the fast tier
+    double slow_ns = 300; //load latency of the slow tier
+    double fast_gbs = 100; //bandwidth of the fast tier in GB/s
+    double slow_gbs = 20; //bandwidth of the slow tier in GB/s
+    int shift; //log2 of the placement unit, the finest region size
+    uint64_t slots; //placement units that fit in the fast tier
+    vector<uint64_t> placed; //region numbers in the fast tier, sorted
+
+    //results of the last interval
+    uint64_t fast_hits = 0; //accesses served by the fast tier
+    uint64_t slow_hits = 0; //accesses served by the slow tier
+    uint64_t promoted = 0; //regions promoted at the start of the interval
+    uint64_t demoted = 0; //regions demoted at the start of the interval
+    double fast_fraction = 0; //fast_hits over all accesses, in percent
+    double avg_latency = 0; //mean access latency in ns, migration included
+    double migration_ns = 0; //time spent moving regions between tiers
+
+    //over the whole run
+    uint64_t intervals = 0;
+    uint64_t total_fast = 0;
+    uint64_t total_slow = 0;
+    uint64_t total_promoted = 0;
+    uint64_t total_demoted = 0;
+    double total_migration_ns = 0;
+
+    /* setup: size the fast tier in placement units
+     * Parameters: int log2 of the finest region size
+     * Returns: None
+     */
+    void setup(int region_bits) {
+      shift = region_bits;
+      slots = capacity >> shift;
+    }
+
+    /* access: charge one access to the tier its region is in
+     * Parameters: uint64_t the address that was accessed
+     * Returns: None
+     */
+    void access(uint64_t addr) {
+      if(binary_search(placed.begin(), placed.end(), addr >> shift)) fast_hits++;
+      else slow_hits++;
+    }
+
+    /* end_interval: work out the results of the interval that just ended
+     * Parameters: None
+     * Returns: None
+     */
+    void end_interval() {
+      uint64_t accesses = fast_hits + slow_hits;
+      double stall = fast_hits*fast_ns + slow_hits*slow_ns;
+
+      fast_fraction = accesses ? 100.0*fast_hits/accesses : 0;
+      avg_latency = accesses ? (stall + migration_ns)/accesses : 0;
+      intervals++;
+      total_fast += fast_hits;
+      total_slow += slow_hits;
+      total_promoted += promoted;
+      total_demoted += demoted;
+      total_migration_ns += migration_ns;
+      fast_hits = 0;
+      slow_hits = 0;
+    }
+
+    /* place: fill the fast tier with the hottest regions, by heat(), the finest
+     *        phase tracked this interval and charge the migrations
+     * Parameters: Global& the tracker
+     *             int 0 while the finest phase is still warming up
+     * Returns: None
+     */
+    template<class Cascade>
+    void place(const Cascade& G, int active) {
+      vector<uint64_t> moved;
+      uint64_t unit = 1ULL << shift;
+      double bandwidth = min(fast_gbs, slow_gbs);
+
+      ranked.clear();
+      if(active) {
+        for(auto& m : G.mmap[2]) {
+          uint64_t value = (m.second < G.counters(2)) ? G.heat(2, m.second) : 0;
+          if(value) ranked.push_back(make_pair(value, m.first));
+        }
+      }
+      if(ranked.size() > slots) {
+        //ties go to the lower region so runs are repeatable
+        nth_element(ranked.begin(), ranked.begin()+slots, ranked.end(),
+          [](const pair<uint64_t, uint64_t>& a, const pair<uint64_t, uint64_t>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+          });
+        ranked.resize(slots);
+      }
+      next.clear();
+      for(auto& r : ranked) next.push_back(r.second);
+      sort(next.begin(), next.end());
+
+      set_difference(next.begin(), next.end(), placed.begin(), placed.end(), back_inserter(moved));
+      promoted = moved.size();
+      moved.clear();
+      set_difference(placed.begin(), placed.end(), next.begin(), next.end(), back_inserter(moved));
+      demoted = moved.size();
+
+      //bytes over GB/s is ns, each move reads one tier and writes the other
+      migration_ns = bandwidth > 0 ? (double)(promoted + demoted)*unit/bandwidth : 0;
+      placed.swap(next);
+    }
+
+  private:
+    vector<pair<uint64_t, uint64_t>> ranked; //(count, region) scratch
+    vector<uint64_t> next; //scratch for the new placement
+};
+
+#endif
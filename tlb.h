@@ -0,0 +1,102 @@
+/* File: tlb.h
+ * Author: Zach McMichael
+ * Description: dTLB miss and page walk counts for this process through
+ *				perf_event_open, to check what --hugepages did to a trace
+ *
+ * dTLB load and store misses use the generic cache events. Page walks have
+ * no generic event, so they are only counted when a raw event is given,
+ * e.g. 0x0e08 (DTLB_LOAD_MISSES.WALK_COMPLETED) on recent Intel cores.
+ * Counters the kernel or the CPU refuse are reported as unavailable.
+ */
+
+#ifndef TLB_H
+#define TLB_H
+
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+using namespace std;
+
+class TlbCounters {
+
+  public:
+    enum { LOAD_MISSES, STORE_MISSES, PAGE_WALKS, COUNTERS };
+
+    int enabled = 0; //only open the counters when --tlb is passed
+    uint64_t walk_event = 0; //raw page walk event, 0 for none
+    int fd[COUNTERS] = {-1, -1, -1};
+    uint64_t value[COUNTERS] = {0, 0, 0};
+    string error; //why the first counter could not be opened
+
+    ~TlbCounters() {
+      for(int c=0; c<COUNTERS; c++) if(fd[c] >= 0) close(fd[c]);
+    }
+
+    /* open: create the counters, stopped
+     * Parameters: None
+     * Returns: bool false if none could be opened
+     */
+    bool open() {
+      int ok = 0;
+
+      if(!enabled) return false;
+      fd[LOAD_MISSES] = open_event(PERF_TYPE_HW_CACHE, dtlb(PERF_COUNT_HW_CACHE_OP_READ));
+      fd[STORE_MISSES] = open_event(PERF_TYPE_HW_CACHE, dtlb(PERF_COUNT_HW_CACHE_OP_WRITE));
+      if(walk_event) fd[PAGE_WALKS] = open_event(PERF_TYPE_RAW, walk_event);
+      for(int c=0; c<COUNTERS; c++) if(fd[c] >= 0) ok++;
+      return ok > 0;
+    }
+
+    void start() {
+      for(int c=0; c<COUNTERS; c++) {
+        if(fd[c] < 0) continue;
+        ioctl(fd[c], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd[c], PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+
+    /* stop: stop counting and read the totals into value
+     * Parameters: None
+     * Returns: None
+     */
+    void stop() {
+      for(int c=0; c<COUNTERS; c++) {
+        if(fd[c] < 0) continue;
+        ioctl(fd[c], PERF_EVENT_IOC_DISABLE, 0);
+        if(read(fd[c], &value[c], sizeof(uint64_t)) != sizeof(uint64_t)) value[c] = 0;
+      }
+    }
+
+    bool available(int c) const {
+      return fd[c] >= 0;
+    }
+
+  private:
+    static uint64_t dtlb(uint64_t op) {
+      return PERF_COUNT_HW_CACHE_DTLB | (op << 8) | ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    int open_event(uint32_t type, uint64_t config) {
+      struct perf_event_attr attr;
+      int f;
+
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = type;
+      attr.config = config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      f = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if(f < 0 && error.empty()) error = strerror(errno);
+      return f;
+    }
+};
+
+#endif
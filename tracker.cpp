@@ -0,0 +1,135 @@
+/* File: tracker.cpp
+ * Author: Zach McMichael
+ * Description: Tracker over the phase cascade of heatmap.h, built into
+ *				libheatmap.a so that programs including tracker.h never see
+ *				heatmap.h
+ */
+
+#include "tracker.h"
+#include "heatmap.h"
+
+struct Tracker::Cascade {
+  Global G;
+};
+
+Tracker::Tracker() : cascade(new Cascade()) {}
+Tracker::~Tracker() = default;
+Tracker::Tracker(Tracker&&) = default;
+Tracker& Tracker::operator=(Tracker&&) = default;
+
+bool Tracker::configure(const TrackerConfig& config, string& error) {
+  int p;
+
+  for(p=0; p<3; p++) {
+    const PhaseConfig& c = config.phase[p];
+    if(c.data_bits < 1 || c.data_bits > 63 || c.region_bits < 0 || c.region_bits > c.data_bits) {
+      error = "phase " + to_string(p) + " needs 0 <= region_bits <= data_bits < 64";
+      return false;
+    }
+    if(c.counter_bits < 1 || c.counter_bits > 63) {
+      error = "phase " + to_string(p) + " needs 1 to 63 counter bits";
+      return false;
+    }
+  }
+
+  cascade.reset(new Cascade());
+  Global& G = cascade->G;
+  G.init();
+  for(p=0; p<3; p++) G.set_phase(p, config.phase[p].data_bits, config.phase[p].region_bits, config.phase[p].counter_bits);
+  G.interval = config.interval;
+  G.verbose = 0;
+  G.debug = 0;
+  G.setup();
+
+  run_shift = min(G.region_shift_0, min(G.mmap_region_zeros[1], G.mmap_region_zeros[2]));
+  interval = config.interval;
+  pause_time = 0;
+  started = false;
+  current = 0;
+  error = "";
+  return true;
+}
+
+void Tracker::record(uint64_t addr, double ts) {
+  boundary(ts);
+  cascade->G.record(addr);
+}
+
+void Tracker::record_batch(heatmap::span<const uint64_t> addrs, double ts) {
+  Global& G = cascade->G;
+  const uint64_t* a = addrs.data();
+  size_t i = 0, j, n = addrs.size();
+
+  boundary(ts);
+  while(i < n) {
+    for(j=i+1; j<n && (a[j] >> run_shift) == (a[i] >> run_shift); j++);
+    G.record_count(a[i], j-i, 0);
+    i = j;
+  }
+}
+
+IntervalStats Tracker::end_interval() {
+  Global& G = cascade->G;
+  IntervalStats s = stats();
+  int p;
+
+  for(p=0; p<3; p++) {
+    G.total_cache_hits[p] += G.cache_hits[p];
+    G.total_cache_misses[p] += G.cache_misses[p];
+    G.total_counter_inc[p] += G.counter_inc[p];
+    G.total_counter_dec[p] += G.counter_dec[p];
+    G.cache_hits[p] = 0;
+    G.cache_misses[p] = 0;
+    G.counter_inc[p] = 0;
+    G.counter_dec[p] = 0;
+  }
+  current++;
+  G.heatmap(current);
+  return s;
+}
+
+vector<HotRegion> Tracker::hot_set(int phase) const {
+  const Global& G = cascade->G;
+  vector<HotRegion> out;
+  uint64_t i;
+
+  if(phase < 0 || phase > 2) return out;
+  if(phase == 0) {
+    for(i=0; i<G.counters(0); i++) {
+      uint64_t count = G.counter(0, i);
+      if(count) out.push_back({i << G.region_shift_0, G.region_size[0], count});
+    }
+  }else{
+    for(auto& m : G.mmap[phase]) {
+      uint64_t count = m.second < G.counters(phase) ? G.counter(phase, m.second) : 0;
+      out.push_back({m.first << G.mmap_region_zeros[phase], G.region_size[phase], count});
+    }
+  }
+  return out;
+}
+
+IntervalStats Tracker::stats() const {
+  const Global& G = cascade->G;
+  IntervalStats s;
+  int p;
+
+  s.iteration = current;
+  s.active_phases = G.active_phases;
+  for(p=0; p<3; p++) {
+    s.phase[p] = {G.cache_hits[p], G.cache_misses[p], G.counter_inc[p], G.counter_dec[p]};
+  }
+  return s;
+}
+
+IntervalStats Tracker::totals() const {
+  const Global& G = cascade->G;
+  IntervalStats s;
+  int p;
+
+  s.iteration = current;
+  s.active_phases = G.active_phases;
+  for(p=0; p<3; p++) {
+    s.phase[p] = {G.total_cache_hits[p], G.total_cache_misses[p], G.total_counter_inc[p], G.total_counter_dec[p]};
+  }
+  return s;
+}
@@ -0,0 +1,162 @@
+/* File: tracker.h
+ * Author: Zach McMichael
+ * Description: embeddable front end to the phase cascade, for programs
+ *				that produce addresses themselves and link libheatmap.a
+ *
+ * Usage:
+ *   TrackerConfig c = {{{44, 34, 4}, {34, 24, 4}, {24, 14, 4}}, 0.5};
+ *   Tracker t;
+ *   std::string error;
+ *   if(!t.configure(c, error)) ...
+ *   t.record(addr, ts);  or  t.record_batch(addrs, ts);
+ *   t.end_interval();    only needed when interval is 0
+ *   t.hot_set(2), t.stats(), t.totals()
+ * Nothing on the record path prints or parses text. The cascade itself
+ * lives in tracker.cpp, so this header pulls in no using directives or
+ * macros and only the standard headers below.
+ */
+
+#ifndef TRACKER_H
+#define TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#if __cplusplus > 201703L && __has_include(<span>)
+#include <span>
+#endif
+
+namespace heatmap {
+
+#if defined(__cpp_lib_span)
+template<class T> using span = std::span<T>;
+#else
+//just enough of std::span for record_batch on c++17
+template<class T>
+class span {
+  public:
+    span() : ptr(nullptr), len(0) {}
+    span(T* data, size_t size) : ptr(data), len(size) {}
+    template<class U, size_t N>
+    span(U (&arr)[N]) : ptr(arr), len(N) {}
+    template<class C>
+    span(C& c) : ptr(c.data()), len(c.size()) {}
+    T* data() const { return ptr; }
+    size_t size() const { return len; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + len; }
+  private:
+    T* ptr;
+    size_t len;
+};
+#endif
+
+}
+
+//one --L argument: log2 of the data covered, log2 of the region size, counter bits
+struct PhaseConfig {
+  int data_bits;
+  int region_bits;
+  int counter_bits;
+};
+
+struct TrackerConfig {
+  PhaseConfig phase[3];
+  double interval; //seconds per interval, 0 to only end intervals by calling end_interval()
+};
+
+//what one phase saw over an interval or a run
+struct PhaseStats {
+  uint64_t cache_hits;
+  uint64_t cache_misses;
+  uint64_t counter_inc;
+  uint64_t counter_full;
+};
+
+struct IntervalStats {
+  uint64_t iteration; //the interval these are for
+  int active_phases; //phases that counted, less than 3 while warming up
+  PhaseStats phase[3];
+};
+
+struct HotRegion {
+  uint64_t base; //first address
+  uint64_t size; //bytes
+  uint64_t count; //counter value this interval
+};
+
+class Tracker {
+
+  public:
+    Tracker();
+    ~Tracker();
+    Tracker(Tracker&&);
+    Tracker& operator=(Tracker&&);
+
+    /* configure: size the phases, discarding any earlier state
+     * Parameters: TrackerConfig& the phases and interval
+     *             string& why it was rejected
+     * Returns: bool false if the configuration is not usable
+     */
+    bool configure(const TrackerConfig& config, std::string& error);
+
+    /* record: count one access, ending the interval first if ts is past it
+     * Parameters: uint64_t the address
+     *             double the timestamp in seconds, ignored when interval is 0
+     * Returns: None
+     */
+    void record(uint64_t addr, double ts);
+
+    /* record_batch: count a run of accesses that share a timestamp, runs
+     *               to the same smallest region are counted as one update
+     * Parameters: span<const uint64_t> the addresses
+     *             double their timestamp in seconds
+     * Returns: None
+     */
+    void record_batch(heatmap::span<const uint64_t> addrs, double ts);
+
+    /* end_interval: close the current interval and rebuild the phases
+     * Parameters: None
+     * Returns: IntervalStats what the interval saw
+     */
+    IntervalStats end_interval();
+
+    /* hot_set: the regions a phase is tracking, phase 0 only lists
+     *          regions with a non-zero counter
+     * Parameters: int the phase
+     * Returns: vector<HotRegion> sorted by base address
+     */
+    std::vector<HotRegion> hot_set(int phase) const;
+
+    //counts of the interval in progress, and of every closed interval
+    IntervalStats stats() const;
+    IntervalStats totals() const;
+
+    uint64_t iteration() const {
+      return current;
+    }
+
+  private:
+    struct Cascade; //the Global from heatmap.h, defined in tracker.cpp
+    std::unique_ptr<Cascade> cascade;
+    double interval = 0;
+    double pause_time = 0;
+    bool started = false;
+    uint64_t current = 0;
+    int run_shift = 0; //log2 of the smallest region, accesses inside one are a run
+
+    void boundary(double ts) {
+      if(interval <= 0) return;
+      if(!started) {
+        started = true;
+        pause_time = ts + interval;
+      }else if(pause_time < ts) {
+        end_interval();
+        pause_time = ts + interval;
+      }
+    }
+};
+
+#endif